@@ -6,7 +6,7 @@ setlocal
 
 REM Set paths
 set NVAPI_DIR=nvapi
-set SRC=native_nvcp_toggle.c
+set SRC=native_nvcp_toggle.c nvcp_backend_gdi.c nvcp_backend_nvapi.c nvcp_backend_stub.c nvcp_backend_timed.c nvcp_base_ramp.c nvcp_caps.c nvcp_config.c nvcp_config_blob.c nvcp_daemon.c nvcp_fade.c nvcp_ipc.c nvcp_journal.c nvcp_latency.c nvcp_lut.c nvcp_output.c nvcp_platform.c nvcp_profile.c nvcp_ramp.c nvcp_ramp_cache.c nvcp_ramp_fixed.c nvcp_ramp_simd.c nvcp_slot_file.c nvcp_thread.c nvcp_timing.c nvcp_toggle.c nvcp_trace.c
 set OUT=native_nvcp_toggle.exe
 
 REM Check for cl.exe
@@ -32,7 +32,7 @@ REM Build 32-bit version
 echo Building 32-bit version...
 cl /nologo /O2 /W3 /D_CRT_SECURE_NO_WARNINGS ^
     /I"%NVAPI_DIR%" ^
-    "%SRC%" ^
+    %SRC% ^
     native_nvcp_toggle.res ^
     "%NVAPI_DIR%\x86\nvapi.lib" ^
     user32.lib gdi32.lib ^
@@ -0,0 +1,50 @@
+/*
+ * NVCP Toggle - Atomic counters
+ * 64-bit lock-free add (returning the previous value) and max for
+ * statistics shared between worker threads
+ */
+
+#ifndef NVCP_ATOMIC_H
+#define NVCP_ATOMIC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+
+static inline uint64_t AtomicAdd64(volatile uint64_t* target, uint64_t value) {
+    return (uint64_t)_InterlockedExchangeAdd64((volatile __int64*)target, (__int64)value);
+}
+
+static inline uint64_t AtomicLoad64(const volatile uint64_t* target) {
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)target, 0, 0);
+}
+
+static inline void AtomicMax64(volatile uint64_t* target, uint64_t value) {
+    uint64_t current = AtomicLoad64(target);
+    while (value > current) {
+        uint64_t seen = (uint64_t)_InterlockedCompareExchange64((volatile __int64*)target,
+                                                                (__int64)value, (__int64)current);
+        if (seen == current) break;
+        current = seen;
+    }
+}
+#else
+static inline uint64_t AtomicAdd64(volatile uint64_t* target, uint64_t value) {
+    return __atomic_fetch_add(target, value, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t AtomicLoad64(const volatile uint64_t* target) {
+    return __atomic_load_n(target, __ATOMIC_RELAXED);
+}
+
+static inline void AtomicMax64(volatile uint64_t* target, uint64_t value) {
+    uint64_t current = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (value > current &&
+           !__atomic_compare_exchange_n(target, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+#endif
+
+#endif /* NVCP_ATOMIC_H */
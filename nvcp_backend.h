@@ -0,0 +1,119 @@
+/*
+ * NVCP Toggle - Display backend interface
+ * All driver and display access from the core goes through a DisplayBackend,
+ * so the toggle logic can run against NVAPI/GDI or an in-memory stand-in.
+ */
+
+#ifndef NVCP_BACKEND_H
+#define NVCP_BACKEND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nvcp_ramp.h"
+
+#define DISPLAY_NAME_SIZE 64  /* Matches NvAPI_ShortString */
+
+/* An opened display: driver handle plus the device used for gamma ramp access */
+typedef struct {
+    void* nvHandle;      /* NvDisplayHandle on Windows */
+    void* rampDevice;    /* HDC on Windows */
+    bool ownsRampDevice; /* false when rampDevice is the shared screen DC */
+    int index;
+    char name[DISPLAY_NAME_SIZE];
+} Display;
+
+/* Driver and display entry points used by the toggle logic */
+typedef struct {
+    const char* name;
+
+    /* Driver lifetime (NvAPI_Initialize, undocumented DVC/HUE lookup, NvAPI_Unload) */
+    bool (*Initialize)(void);
+    bool (*LoadExtensions)(void);
+    void (*Unload)(void);
+
+    /* Display enumeration; OpenDisplay returns false past the last display */
+    bool (*OpenDisplay)(int index, Display* display);
+    bool (*OpenPrimaryDisplay)(Display* display);
+    void (*CloseDisplay)(Display* display);
+
+    /* Digital vibrance and hue */
+    bool (*GetDVCInfo)(const Display* display, int* level, int* minLevel, int* maxLevel);
+    bool (*GetDVCRange)(const Display* display, int* minLevel, int* maxLevel);  /* Cached, no driver call */
+    bool (*SetDVCLevel)(const Display* display, int level);
+    bool (*GetHueInfo)(const Display* display, int* angle);
+    bool (*SetHueAngle)(const Display* display, int angle);
+
+    /* Device gamma ramp */
+    bool (*GetGammaRamp)(const Display* display, GammaRamp* ramp);
+    bool (*SetGammaRamp)(const Display* display, const GammaRamp* ramp);
+} DisplayBackend;
+
+/*
+ * Wrap a backend so every call is recorded in the driver latency histograms
+ * (see nvcp_latency.h). There is one shim; wrapping again replaces the inner backend.
+ */
+const DisplayBackend* GetTimedBackend(const DisplayBackend* backend);
+
+#ifdef _WIN32
+/*
+ * NVAPI + GDI backend (Windows only)
+ */
+const DisplayBackend* GetNvapiBackend(void);
+
+/*
+ * GDI gamma ramps only, on every attached display; never loads NVAPI
+ * (Windows only)
+ */
+const DisplayBackend* GetGdiBackend(void);
+#endif
+
+/*
+ * In-memory stand-in backend: keeps per-display DVC, hue and ramp state and
+ * records every write, so the toggle path can run without a GPU
+ */
+#define STUB_MAX_DISPLAYS 16
+
+typedef struct {
+    int dvcLevel;
+    int dvcMin;
+    int dvcMax;
+    int hue;
+    GammaRamp ramp;
+    unsigned dvcWrites;
+    unsigned hueWrites;
+    unsigned rampWrites;
+    unsigned failedCalls;  /* Reads and writes the driver model failed */
+} StubDisplay;
+
+/* Simulated driver cost for the stand-in, for benchmarking without hardware */
+typedef struct {
+    uint64_t initializeNs;  /* Initialize, LoadExtensions */
+    uint64_t openNs;        /* OpenDisplay, OpenPrimaryDisplay, CloseDisplay */
+    uint64_t nvapiReadNs;   /* GetDVCInfo, GetHueInfo */
+    uint64_t nvapiWriteNs;  /* SetDVCLevel, SetHueAngle */
+    uint64_t rampReadNs;    /* GetGammaRamp */
+    uint64_t rampWriteNs;   /* SetGammaRamp */
+    double jitter;          /* Each latency varies uniformly by +-jitter of itself */
+    double failureRate;     /* Chance a display read or write fails, 0-1 */
+} StubDriverModel;
+
+const DisplayBackend* GetStubBackend(void);
+
+/*
+ * Reset the stand-in to displayCount displays in the default state
+ */
+void StubBackendReset(int displayCount);
+
+/*
+ * Recorded state of a stand-in display, NULL if index is out of range
+ */
+const StubDisplay* StubBackendGetDisplay(int index);
+
+/*
+ * Make stand-in calls take time and fail like a real driver would; NULL
+ * restores instant, always-succeeding calls
+ */
+void StubBackendSetDriverModel(const StubDriverModel* model);
+
+#endif /* NVCP_BACKEND_H */
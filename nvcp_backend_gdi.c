@@ -0,0 +1,134 @@
+/*
+ * NVCP Toggle - GDI-only backend
+ * Gamma ramps via Windows GDI on every display attached to the desktop.
+ * Never initializes NVAPI, so nvapi.dll / nvapi64.dll is not loaded;
+ * vibrance and hue are unavailable.
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nvcp_backend.h"
+#include "nvcp_latency.h"
+#include "nvcp_timing.h"
+
+static bool GdiInitialize(void) {
+    return true;
+}
+
+static bool GdiLoadExtensions(void) {
+    return true;
+}
+
+static void GdiUnload(void) {
+}
+
+/*
+ * Find the index-th display attached to the desktop, or the primary one
+ * when index is negative
+ */
+static bool FindDisplayDevice(int index, DISPLAY_DEVICEA* dd) {
+    int attached = 0;
+    dd->cb = sizeof(*dd);
+
+    for (DWORD i = 0; EnumDisplayDevicesA(NULL, i, dd, 0); i++) {
+        if (!(dd->StateFlags & DISPLAY_DEVICE_ATTACHED_TO_DESKTOP)) continue;
+        if (index < 0 ? (dd->StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE) != 0 : attached == index) return true;
+        attached++;
+    }
+    return false;
+}
+
+static bool OpenDisplayDevice(int index, Display* display) {
+    DISPLAY_DEVICEA dd;
+    TIMING_BEGIN(enumStart);
+    DRIVER_CALL_BEGIN(enumCallStart);
+    bool found = FindDisplayDevice(index, &dd);
+    DRIVER_CALL_END(CALL_ENUM_DISPLAY_HANDLE, enumCallStart);
+    TIMING_END(PHASE_ENUMERATE, enumStart);
+    if (!found) return false;
+
+    memset(display, 0, sizeof(*display));
+    display->index = index < 0 ? 0 : index;
+    snprintf(display->name, sizeof(display->name), "%s", dd.DeviceName);
+
+    TIMING_BEGIN(dcStart);
+    DRIVER_CALL_BEGIN(createStart);
+    HDC hdc = CreateDCA("DISPLAY", dd.DeviceName, NULL, NULL);
+    DRIVER_CALL_END(CALL_CREATE_DC, createStart);
+    TIMING_END(PHASE_CREATE_DC, dcStart);
+    if (!hdc) return false;
+
+    display->rampDevice = hdc;
+    display->ownsRampDevice = true;
+    return true;
+}
+
+static bool GdiOpenDisplay(int index, Display* display) {
+    return OpenDisplayDevice(index, display);
+}
+
+static bool GdiOpenPrimaryDisplay(Display* display) {
+    return OpenDisplayDevice(-1, display);
+}
+
+static void GdiCloseDisplay(Display* display) {
+    if (display->rampDevice) DeleteDC((HDC)display->rampDevice);
+    display->rampDevice = NULL;
+}
+
+static bool GdiGetDVCInfo(const Display* display, int* level, int* minLevel, int* maxLevel) {
+    (void)display; (void)level; (void)minLevel; (void)maxLevel;
+    return false;
+}
+
+static bool GdiGetDVCRange(const Display* display, int* minLevel, int* maxLevel) {
+    (void)display; (void)minLevel; (void)maxLevel;
+    return false;
+}
+
+static bool GdiSetDVCLevel(const Display* display, int level) {
+    (void)display; (void)level;
+    return false;
+}
+
+static bool GdiGetHueInfo(const Display* display, int* angle) {
+    (void)display; (void)angle;
+    return false;
+}
+
+static bool GdiSetHueAngle(const Display* display, int angle) {
+    (void)display; (void)angle;
+    return false;
+}
+
+static bool GdiGetGammaRamp(const Display* display, GammaRamp* ramp) {
+    return GetDeviceGammaRamp((HDC)display->rampDevice, ramp->ch) != FALSE;
+}
+
+static bool GdiSetGammaRamp(const Display* display, const GammaRamp* ramp) {
+    return SetDeviceGammaRamp((HDC)display->rampDevice, (LPVOID)ramp->ch) != FALSE;
+}
+
+static const DisplayBackend gdiBackend = {
+    "gdi",
+    GdiInitialize,
+    GdiLoadExtensions,
+    GdiUnload,
+    GdiOpenDisplay,
+    GdiOpenPrimaryDisplay,
+    GdiCloseDisplay,
+    GdiGetDVCInfo,
+    GdiGetDVCRange,
+    GdiSetDVCLevel,
+    GdiGetHueInfo,
+    GdiSetHueAngle,
+    GdiGetGammaRamp,
+    GdiSetGammaRamp,
+};
+
+const DisplayBackend* GetGdiBackend(void) {
+    return &gdiBackend;
+}
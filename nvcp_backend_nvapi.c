@@ -0,0 +1,376 @@
+/*
+ * NVCP Toggle - NVAPI + GDI backend
+ * Digital vibrance and hue via undocumented NVAPI, gamma ramp via Windows GDI
+ */
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Include NVAPI */
+#include "nvapi/nvapi.h"
+
+#include "nvcp_backend.h"
+#include "nvcp_caps.h"
+#include "nvcp_latency.h"
+#include "nvcp_platform.h"
+#include "nvcp_timing.h"
+
+/*
+ * Undocumented NVAPI function IDs for Digital Vibrance Control and HUE
+ * From: https://github.com/falahati/NvAPIWrapper/blob/master/NvAPIWrapper/Native/Helpers/FunctionId.cs
+ */
+#define NVAPI_GPU_GETDVCINFO        0x4085DE45
+#define NVAPI_GPU_SETDVCLEVEL       0x172409B4
+#define NVAPI_GPU_GETHUEINFO        0x95B64341
+#define NVAPI_GPU_SETHUEANGLE       0xF5A0F22C
+
+/* DVC Info structure (version 1) */
+typedef struct {
+    NvU32 version;
+    NvS32 currentLevel;
+    NvS32 minLevel;
+    NvS32 maxLevel;
+} NV_GPU_DVC_INFO_V1;
+
+#define NV_GPU_DVC_INFO_VER1 MAKE_NVAPI_VERSION(NV_GPU_DVC_INFO_V1, 1)
+
+/* HUE Info structure (version 1) */
+typedef struct {
+    NvU32 version;
+    NvS32 currentAngle;
+    NvS32 defaultAngle;
+} NV_GPU_HUE_INFO_V1;
+
+#define NV_GPU_HUE_INFO_VER1 MAKE_NVAPI_VERSION(NV_GPU_HUE_INFO_V1, 1)
+
+/* Function pointer types for undocumented APIs */
+typedef NvAPI_Status (*PFNNVAPI_GPU_GETDVCINFO)(NvDisplayHandle, NvU32, NV_GPU_DVC_INFO_V1*);
+typedef NvAPI_Status (*PFNNVAPI_GPU_SETDVCLEVEL)(NvDisplayHandle, NvU32, NvS32);
+typedef NvAPI_Status (*PFNNVAPI_GPU_GETHUEINFO)(NvDisplayHandle, NvU32, NV_GPU_HUE_INFO_V1*);
+typedef NvAPI_Status (*PFNNVAPI_GPU_SETHUEANGLE)(NvDisplayHandle, NvU32, NvS32);
+
+/* Global function pointers */
+static PFNNVAPI_GPU_GETDVCINFO  pfnNvAPI_GPU_GetDVCInfo = NULL;
+static PFNNVAPI_GPU_SETDVCLEVEL pfnNvAPI_GPU_SetDVCLevel = NULL;
+static PFNNVAPI_GPU_GETHUEINFO  pfnNvAPI_GPU_GetHUEInfo = NULL;
+static PFNNVAPI_GPU_SETHUEANGLE pfnNvAPI_GPU_SetHUEAngle = NULL;
+
+/* Query interface function - needed to get undocumented functions */
+typedef void* (*NvAPI_QueryInterface_t)(unsigned int offset);
+static NvAPI_QueryInterface_t NvAPI_QueryInterface = NULL;
+
+/* Capability cache for this driver version, and the copy last written */
+static DriverCaps caps;
+static DriverCaps savedCaps;
+static char capsPath[NVCP_MAX_PATH];
+
+/*
+ * Load what earlier runs learned about this driver version; caching is off
+ * if the version can't be read
+ */
+static void LoadCapabilities(void) {
+    NvU32 driverVersion = 0;
+    NvAPI_ShortString branch;
+    capsPath[0] = '\0';
+    memset(&caps, 0, sizeof(caps));
+
+    if (NvAPI_SYS_GetDriverAndBranchVersion(&driverVersion, branch) == NVAPI_OK) {
+        GetPathNextToExe(CAPS_FILE_NAME, capsPath, sizeof(capsPath));
+        LoadDriverCaps(capsPath, driverVersion, &caps);
+    }
+    savedCaps = caps;
+}
+
+/*
+ * Write the capability cache if this run learned something new
+ */
+static void SaveCapabilities(void) {
+    if (capsPath[0] && memcmp(&caps, &savedCaps, sizeof(caps)) != 0) {
+        SaveDriverCaps(capsPath, &caps);
+        savedCaps = caps;
+    }
+}
+
+/*
+ * Resolve an undocumented entry point unless this driver is known to lack it
+ */
+static void* QueryCapability(DriverCapability cap, unsigned int id) {
+    if (caps.missing & CAP_BIT(cap)) return NULL;
+    void* entry = NvAPI_QueryInterface(id);
+    if (!entry) caps.missing |= CAP_BIT(cap);
+    return entry;
+}
+
+/*
+ * Whether the driver already rejected a call as unsupported on this display
+ */
+static bool IsKnownUnsupported(const Display* display, DriverCapability cap) {
+    const DisplayCaps* displayCaps = GetDisplayCaps(&caps, display->index);
+    return displayCaps && (displayCaps->unsupported & CAP_BIT(cap));
+}
+
+/*
+ * Remember a call the driver rejected as unsupported on this display;
+ * other errors may be transient and are not cached
+ */
+static void RecordCallStatus(const Display* display, DriverCapability cap, NvAPI_Status status) {
+    if (status != NVAPI_NOT_SUPPORTED && status != NVAPI_NO_IMPLEMENTATION) return;
+    DisplayCaps* displayCaps = GetDisplayCaps(&caps, display->index);
+    if (displayCaps) displayCaps->unsupported |= CAP_BIT(cap);
+}
+
+/*
+ * Initialize NVAPI
+ */
+static bool NvapiInitialize(void) {
+    NvAPI_Status status = NvAPI_Initialize();
+    if (status != NVAPI_OK) {
+        NvAPI_ShortString errorStr;
+        NvAPI_GetErrorMessage(status, errorStr);
+        printf("ERROR: Unable to initialize NVAPI: %s\n", errorStr);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Initialize undocumented NVAPI functions by querying their addresses
+ */
+static bool InitUndocumentedNvAPI(void) {
+    HMODULE hNvapi = NULL;
+
+#ifdef _WIN64
+    hNvapi = LoadLibraryA("nvapi64.dll");
+#else
+    hNvapi = LoadLibraryA("nvapi.dll");
+#endif
+
+    if (!hNvapi) {
+        printf("ERROR: Could not load nvapi dll\n");
+        return false;
+    }
+
+    NvAPI_QueryInterface = (NvAPI_QueryInterface_t)GetProcAddress(hNvapi, "nvapi_QueryInterface");
+    if (!NvAPI_QueryInterface) {
+        printf("ERROR: Could not find nvapi_QueryInterface\n");
+        return false;
+    }
+
+    LoadCapabilities();
+    pfnNvAPI_GPU_GetDVCInfo = (PFNNVAPI_GPU_GETDVCINFO)QueryCapability(CAP_GET_DVC_INFO, NVAPI_GPU_GETDVCINFO);
+    pfnNvAPI_GPU_SetDVCLevel = (PFNNVAPI_GPU_SETDVCLEVEL)QueryCapability(CAP_SET_DVC_LEVEL, NVAPI_GPU_SETDVCLEVEL);
+    pfnNvAPI_GPU_GetHUEInfo = (PFNNVAPI_GPU_GETHUEINFO)QueryCapability(CAP_GET_HUE_INFO, NVAPI_GPU_GETHUEINFO);
+    pfnNvAPI_GPU_SetHUEAngle = (PFNNVAPI_GPU_SETHUEANGLE)QueryCapability(CAP_SET_HUE_ANGLE, NVAPI_GPU_SETHUEANGLE);
+
+    return true;
+}
+
+static void NvapiUnload(void) {
+    SaveCapabilities();
+    NvAPI_Unload();
+}
+
+/*
+ * Get a proper DC for gamma ramp control
+ */
+static HDC GetGammaRampDC(void) {
+    /* Try to get DC for the primary display device */
+    DISPLAY_DEVICEA dd;
+    dd.cb = sizeof(dd);
+
+    for (DWORD i = 0; EnumDisplayDevicesA(NULL, i, &dd, 0); i++) {
+        if (dd.StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE) {
+            HDC hdc = CreateDCA("DISPLAY", dd.DeviceName, NULL, NULL);
+            if (hdc) return hdc;
+        }
+    }
+
+    /* Fallback to screen DC */
+    return CreateDCA("DISPLAY", NULL, NULL, NULL);
+}
+
+static bool NvapiOpenDisplay(int index, Display* display) {
+    NvDisplayHandle hDisplay;
+    TIMING_BEGIN(enumStart);
+    DRIVER_CALL_BEGIN(enumCallStart);
+    NvAPI_Status enumStatus = NvAPI_EnumNvidiaDisplayHandle(index, &hDisplay);
+    DRIVER_CALL_END(CALL_ENUM_DISPLAY_HANDLE, enumCallStart);
+    if (enumStatus != NVAPI_OK) {
+        TIMING_END(PHASE_ENUMERATE, enumStart);
+        return false;
+    }
+
+    memset(display, 0, sizeof(*display));
+    display->nvHandle = hDisplay;
+    display->index = index;
+
+    NvAPI_ShortString displayName;
+    DRIVER_CALL_BEGIN(nameStart);
+    NvAPI_Status nameStatus = NvAPI_GetAssociatedNvidiaDisplayName(hDisplay, displayName);
+    DRIVER_CALL_END(CALL_GET_DISPLAY_NAME, nameStart);
+    if (nameStatus != NVAPI_OK) {
+        snprintf(displayName, sizeof(displayName), "Display %d", index);
+    }
+    snprintf(display->name, sizeof(display->name), "%s", displayName);
+    ClaimDisplayCaps(&caps, display->index, display->name);
+    TIMING_END(PHASE_ENUMERATE, enumStart);
+
+    /* Get DC for this display */
+    TIMING_BEGIN(dcStart);
+    DRIVER_CALL_BEGIN(createStart);
+    HDC hdc = CreateDCA("DISPLAY", displayName, NULL, NULL);
+    DRIVER_CALL_END(CALL_CREATE_DC, createStart);
+    display->ownsRampDevice = (hdc != NULL);
+    if (!hdc) {
+        hdc = GetDC(NULL); /* Fallback to primary */
+    }
+    display->rampDevice = hdc;
+    TIMING_END(PHASE_CREATE_DC, dcStart);
+
+    return true;
+}
+
+static bool NvapiOpenPrimaryDisplay(Display* display) {
+    NvDisplayHandle hDisplay;
+    TIMING_BEGIN(enumStart);
+    DRIVER_CALL_BEGIN(enumCallStart);
+    NvAPI_Status enumStatus = NvAPI_EnumNvidiaDisplayHandle(0, &hDisplay);
+    DRIVER_CALL_END(CALL_ENUM_DISPLAY_HANDLE, enumCallStart);
+    if (enumStatus != NVAPI_OK) {
+        TIMING_END(PHASE_ENUMERATE, enumStart);
+        return false;
+    }
+
+    memset(display, 0, sizeof(*display));
+    display->nvHandle = hDisplay;
+
+    NvAPI_ShortString displayName;
+    DRIVER_CALL_BEGIN(nameStart);
+    NvAPI_Status nameStatus = NvAPI_GetAssociatedNvidiaDisplayName(hDisplay, displayName);
+    DRIVER_CALL_END(CALL_GET_DISPLAY_NAME, nameStart);
+    if (nameStatus != NVAPI_OK) {
+        strcpy(displayName, "Primary Display");
+    }
+    snprintf(display->name, sizeof(display->name), "%s", displayName);
+    ClaimDisplayCaps(&caps, display->index, display->name);
+    TIMING_END(PHASE_ENUMERATE, enumStart);
+
+    TIMING_BEGIN(dcStart);
+    DRIVER_CALL_BEGIN(createStart);
+    display->rampDevice = GetGammaRampDC();
+    DRIVER_CALL_END(CALL_CREATE_DC, createStart);
+    display->ownsRampDevice = true;
+    TIMING_END(PHASE_CREATE_DC, dcStart);
+
+    return true;
+}
+
+static void NvapiCloseDisplay(Display* display) {
+    HDC hdc = (HDC)display->rampDevice;
+    if (hdc) {
+        if (display->ownsRampDevice) {
+            DeleteDC(hdc);
+        } else {
+            ReleaseDC(NULL, hdc);
+        }
+    }
+    display->rampDevice = NULL;
+    display->nvHandle = NULL;
+}
+
+static bool NvapiGetDVCInfo(const Display* display, int* level, int* minLevel, int* maxLevel) {
+    if (!pfnNvAPI_GPU_GetDVCInfo || IsKnownUnsupported(display, CAP_GET_DVC_INFO)) return false;
+
+    NV_GPU_DVC_INFO_V1 dvcInfo = {0};
+    dvcInfo.version = NV_GPU_DVC_INFO_VER1;
+
+    NvAPI_Status status = pfnNvAPI_GPU_GetDVCInfo((NvDisplayHandle)display->nvHandle, 0, &dvcInfo);
+    if (status != NVAPI_OK) {
+        RecordCallStatus(display, CAP_GET_DVC_INFO, status);
+        return false;
+    }
+
+    *level = dvcInfo.currentLevel;
+    *minLevel = dvcInfo.minLevel;
+    *maxLevel = dvcInfo.maxLevel;
+
+    DisplayCaps* displayCaps = GetDisplayCaps(&caps, display->index);
+    if (displayCaps) {
+        displayCaps->dvcMin = dvcInfo.minLevel;
+        displayCaps->dvcMax = dvcInfo.maxLevel;
+        displayCaps->rangeKnown = 1;
+    }
+    return true;
+}
+
+static bool NvapiGetDVCRange(const Display* display, int* minLevel, int* maxLevel) {
+    const DisplayCaps* displayCaps = GetDisplayCaps(&caps, display->index);
+    if (!displayCaps || !displayCaps->rangeKnown) return false;
+
+    *minLevel = displayCaps->dvcMin;
+    *maxLevel = displayCaps->dvcMax;
+    return true;
+}
+
+static bool NvapiSetDVCLevel(const Display* display, int level) {
+    if (!pfnNvAPI_GPU_SetDVCLevel || IsKnownUnsupported(display, CAP_SET_DVC_LEVEL)) return false;
+
+    NvAPI_Status status = pfnNvAPI_GPU_SetDVCLevel((NvDisplayHandle)display->nvHandle, 0, level);
+    RecordCallStatus(display, CAP_SET_DVC_LEVEL, status);
+    return status == NVAPI_OK;
+}
+
+static bool NvapiGetHueInfo(const Display* display, int* angle) {
+    if (!pfnNvAPI_GPU_GetHUEInfo || IsKnownUnsupported(display, CAP_GET_HUE_INFO)) return false;
+
+    NV_GPU_HUE_INFO_V1 hueInfo = {0};
+    hueInfo.version = NV_GPU_HUE_INFO_VER1;
+
+    NvAPI_Status status = pfnNvAPI_GPU_GetHUEInfo((NvDisplayHandle)display->nvHandle, 0, &hueInfo);
+    if (status != NVAPI_OK) {
+        RecordCallStatus(display, CAP_GET_HUE_INFO, status);
+        return false;
+    }
+
+    *angle = hueInfo.currentAngle;
+    return true;
+}
+
+static bool NvapiSetHueAngle(const Display* display, int angle) {
+    if (!pfnNvAPI_GPU_SetHUEAngle || IsKnownUnsupported(display, CAP_SET_HUE_ANGLE)) return false;
+
+    NvAPI_Status status = pfnNvAPI_GPU_SetHUEAngle((NvDisplayHandle)display->nvHandle, 0, angle);
+    RecordCallStatus(display, CAP_SET_HUE_ANGLE, status);
+    return status == NVAPI_OK;
+}
+
+static bool NvapiGetGammaRamp(const Display* display, GammaRamp* ramp) {
+    return GetDeviceGammaRamp((HDC)display->rampDevice, ramp->ch) != FALSE;
+}
+
+static bool NvapiSetGammaRamp(const Display* display, const GammaRamp* ramp) {
+    return SetDeviceGammaRamp((HDC)display->rampDevice, (LPVOID)ramp->ch) != FALSE;
+}
+
+static const DisplayBackend nvapiBackend = {
+    "nvapi",
+    NvapiInitialize,
+    InitUndocumentedNvAPI,
+    NvapiUnload,
+    NvapiOpenDisplay,
+    NvapiOpenPrimaryDisplay,
+    NvapiCloseDisplay,
+    NvapiGetDVCInfo,
+    NvapiGetDVCRange,
+    NvapiSetDVCLevel,
+    NvapiGetHueInfo,
+    NvapiSetHueAngle,
+    NvapiGetGammaRamp,
+    NvapiSetGammaRamp,
+};
+
+const DisplayBackend* GetNvapiBackend(void) {
+    return &nvapiBackend;
+}
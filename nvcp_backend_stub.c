@@ -0,0 +1,234 @@
+/*
+ * NVCP Toggle - In-memory stand-in backend
+ * Emulates NVAPI DVC/HUE and GDI gamma ramps for headless builds
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_backend.h"
+#include "nvcp_platform.h"
+
+/* Sleep most of a simulated call, as a blocked driver call would, and spin the rest */
+#define STUB_SPIN_NS 100000ull
+
+static StubDisplay stubDisplays[STUB_MAX_DISPLAYS];
+static int stubDisplayCount = 0;
+
+static StubDriverModel stubModel;
+static bool stubModelEnabled = false;
+
+/*
+ * Random streams for jitter and failures: one per display, so workers never
+ * share one, plus one for the calls that are not per display
+ */
+static uint64_t stubRandom[STUB_MAX_DISPLAYS + 1];
+
+static void SeedStubRandom(void) {
+    for (int i = 0; i <= STUB_MAX_DISPLAYS; i++) {
+        stubRandom[i] = 0x9E3779B97F4A7C15ull * (uint64_t)(i + 1);
+    }
+}
+
+/*
+ * Uniform random number in [0, 1) (xorshift64*)
+ */
+static double NextStubRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return (double)((x * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void SimulateLatency(uint64_t ns, uint64_t* random) {
+    if (ns == 0) return;
+    if (stubModel.jitter > 0) {
+        double scale = 1.0 + stubModel.jitter * (2.0 * NextStubRandom(random) - 1.0);
+        ns = scale > 0 ? (uint64_t)((double)ns * scale) : 0;
+    }
+
+    uint64_t deadline = GetMonotonicNs() + ns;
+    for (uint64_t now = GetMonotonicNs(); now < deadline; now = GetMonotonicNs()) {
+        if (deadline - now > STUB_SPIN_NS) SleepNs(deadline - now - STUB_SPIN_NS);
+    }
+}
+
+/*
+ * Cost of a call that is not tied to a display
+ */
+static void SimulateCall(uint64_t ns) {
+    if (stubModelEnabled) SimulateLatency(ns, &stubRandom[STUB_MAX_DISPLAYS]);
+}
+
+/*
+ * Cost of a display read or write; false if the model fails it
+ */
+static bool SimulateDisplayCall(const Display* display, uint64_t ns) {
+    if (!stubModelEnabled) return true;
+
+    StubDisplay* d = (StubDisplay*)display->nvHandle;
+    uint64_t* random = &stubRandom[d - stubDisplays];
+    SimulateLatency(ns, random);
+    if (stubModel.failureRate > 0 && NextStubRandom(random) < stubModel.failureRate) {
+        d->failedCalls++;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Make stand-in calls take time and fail like a real driver would; NULL
+ * restores instant, always-succeeding calls
+ */
+void StubBackendSetDriverModel(const StubDriverModel* model) {
+    stubModelEnabled = (model != NULL);
+    if (model) stubModel = *model;
+    SeedStubRandom();
+}
+
+/*
+ * Reset the stand-in to displayCount displays in the default state
+ */
+void StubBackendReset(int displayCount) {
+    if (displayCount < 1) displayCount = 1;
+    if (displayCount > STUB_MAX_DISPLAYS) displayCount = STUB_MAX_DISPLAYS;
+
+    memset(stubDisplays, 0, sizeof(stubDisplays));
+    for (int i = 0; i < displayCount; i++) {
+        StubDisplay* d = &stubDisplays[i];
+        d->dvcMax = 63;
+        d->ramp = DefaultGammaRamp;
+    }
+    stubDisplayCount = displayCount;
+    SeedStubRandom();
+}
+
+/*
+ * Recorded state of a stand-in display, NULL if index is out of range
+ */
+const StubDisplay* StubBackendGetDisplay(int index) {
+    if (index < 0 || index >= stubDisplayCount) return NULL;
+    return &stubDisplays[index];
+}
+
+static StubDisplay* StubFromDisplay(const Display* display) {
+    return (StubDisplay*)display->nvHandle;
+}
+
+static bool StubInitialize(void) {
+    SimulateCall(stubModel.initializeNs);
+    if (stubDisplayCount == 0) {
+        /* Display count can be set from the environment for headless runs */
+        const char* count = getenv("NVCP_STUB_DISPLAYS");
+        StubBackendReset(count ? atoi(count) : 1);
+    }
+    return true;
+}
+
+static bool StubLoadExtensions(void) {
+    SimulateCall(stubModel.initializeNs);
+    return true;
+}
+
+static void StubUnload(void) {
+}
+
+static bool StubOpenDisplay(int index, Display* display) {
+    SimulateCall(stubModel.openNs);
+    if (index < 0 || index >= stubDisplayCount) return false;
+
+    memset(display, 0, sizeof(*display));
+    display->nvHandle = &stubDisplays[index];
+    display->rampDevice = &stubDisplays[index];
+    display->ownsRampDevice = true;
+    display->index = index;
+    snprintf(display->name, sizeof(display->name), "\\\\.\\DISPLAY%d", index + 1);
+    return true;
+}
+
+static bool StubOpenPrimaryDisplay(Display* display) {
+    return StubOpenDisplay(0, display);
+}
+
+static void StubCloseDisplay(Display* display) {
+    SimulateCall(stubModel.openNs);
+    display->nvHandle = NULL;
+    display->rampDevice = NULL;
+}
+
+static bool StubGetDVCInfo(const Display* display, int* level, int* minLevel, int* maxLevel) {
+    if (!SimulateDisplayCall(display, stubModel.nvapiReadNs)) return false;
+    const StubDisplay* d = StubFromDisplay(display);
+    *level = d->dvcLevel;
+    *minLevel = d->dvcMin;
+    *maxLevel = d->dvcMax;
+    return true;
+}
+
+static bool StubGetDVCRange(const Display* display, int* minLevel, int* maxLevel) {
+    const StubDisplay* d = StubFromDisplay(display);
+    *minLevel = d->dvcMin;
+    *maxLevel = d->dvcMax;
+    return true;
+}
+
+static bool StubSetDVCLevel(const Display* display, int level) {
+    if (!SimulateDisplayCall(display, stubModel.nvapiWriteNs)) return false;
+    StubDisplay* d = StubFromDisplay(display);
+    if (level < d->dvcMin || level > d->dvcMax) return false;
+    d->dvcLevel = level;
+    d->dvcWrites++;
+    return true;
+}
+
+static bool StubGetHueInfo(const Display* display, int* angle) {
+    if (!SimulateDisplayCall(display, stubModel.nvapiReadNs)) return false;
+    *angle = StubFromDisplay(display)->hue;
+    return true;
+}
+
+static bool StubSetHueAngle(const Display* display, int angle) {
+    if (!SimulateDisplayCall(display, stubModel.nvapiWriteNs)) return false;
+    StubDisplay* d = StubFromDisplay(display);
+    d->hue = angle;
+    d->hueWrites++;
+    return true;
+}
+
+static bool StubGetGammaRamp(const Display* display, GammaRamp* ramp) {
+    if (!SimulateDisplayCall(display, stubModel.rampReadNs)) return false;
+    *ramp = StubFromDisplay(display)->ramp;
+    return true;
+}
+
+static bool StubSetGammaRamp(const Display* display, const GammaRamp* ramp) {
+    if (!SimulateDisplayCall(display, stubModel.rampWriteNs)) return false;
+    StubDisplay* d = StubFromDisplay(display);
+    d->ramp = *ramp;
+    d->rampWrites++;
+    return true;
+}
+
+static const DisplayBackend stubBackend = {
+    "stub",
+    StubInitialize,
+    StubLoadExtensions,
+    StubUnload,
+    StubOpenDisplay,
+    StubOpenPrimaryDisplay,
+    StubCloseDisplay,
+    StubGetDVCInfo,
+    StubGetDVCRange,
+    StubSetDVCLevel,
+    StubGetHueInfo,
+    StubSetHueAngle,
+    StubGetGammaRamp,
+    StubSetGammaRamp,
+};
+
+const DisplayBackend* GetStubBackend(void) {
+    return &stubBackend;
+}
@@ -0,0 +1,122 @@
+/*
+ * NVCP Toggle - Timing shim backend
+ * Forwards every entry point to another backend and records its latency.
+ * Installed only when latency recording is on, so normal runs pay nothing.
+ */
+
+#include "nvcp_backend.h"
+#include "nvcp_latency.h"
+
+static const DisplayBackend* inner;
+
+static bool TimedInitialize(void) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->Initialize();
+    DRIVER_CALL_END(CALL_INITIALIZE, start);
+    return ok;
+}
+
+static bool TimedLoadExtensions(void) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->LoadExtensions();
+    DRIVER_CALL_END(CALL_LOAD_EXTENSIONS, start);
+    return ok;
+}
+
+static void TimedUnload(void) {
+    DRIVER_CALL_BEGIN(start);
+    inner->Unload();
+    DRIVER_CALL_END(CALL_UNLOAD, start);
+}
+
+static bool TimedOpenDisplay(int index, Display* display) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->OpenDisplay(index, display);
+    DRIVER_CALL_END(CALL_OPEN_DISPLAY, start);
+    return ok;
+}
+
+static bool TimedOpenPrimaryDisplay(Display* display) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->OpenPrimaryDisplay(display);
+    DRIVER_CALL_END(CALL_OPEN_DISPLAY, start);
+    return ok;
+}
+
+static void TimedCloseDisplay(Display* display) {
+    DRIVER_CALL_BEGIN(start);
+    inner->CloseDisplay(display);
+    DRIVER_CALL_END(CALL_CLOSE_DISPLAY, start);
+}
+
+static bool TimedGetDVCInfo(const Display* display, int* level, int* minLevel, int* maxLevel) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->GetDVCInfo(display, level, minLevel, maxLevel);
+    DRIVER_CALL_END(CALL_GET_DVC_INFO, start);
+    return ok;
+}
+
+static bool TimedGetDVCRange(const Display* display, int* minLevel, int* maxLevel) {
+    return inner->GetDVCRange(display, minLevel, maxLevel);
+}
+
+static bool TimedSetDVCLevel(const Display* display, int level) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->SetDVCLevel(display, level);
+    DRIVER_CALL_END(CALL_SET_DVC_LEVEL, start);
+    return ok;
+}
+
+static bool TimedGetHueInfo(const Display* display, int* angle) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->GetHueInfo(display, angle);
+    DRIVER_CALL_END(CALL_GET_HUE_INFO, start);
+    return ok;
+}
+
+static bool TimedSetHueAngle(const Display* display, int angle) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->SetHueAngle(display, angle);
+    DRIVER_CALL_END(CALL_SET_HUE_ANGLE, start);
+    return ok;
+}
+
+static bool TimedGetGammaRamp(const Display* display, GammaRamp* ramp) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->GetGammaRamp(display, ramp);
+    DRIVER_CALL_END(CALL_GET_GAMMA_RAMP, start);
+    return ok;
+}
+
+static bool TimedSetGammaRamp(const Display* display, const GammaRamp* ramp) {
+    DRIVER_CALL_BEGIN(start);
+    bool ok = inner->SetGammaRamp(display, ramp);
+    DRIVER_CALL_END(CALL_SET_GAMMA_RAMP, start);
+    return ok;
+}
+
+static DisplayBackend timedBackend = {
+    NULL,
+    TimedInitialize,
+    TimedLoadExtensions,
+    TimedUnload,
+    TimedOpenDisplay,
+    TimedOpenPrimaryDisplay,
+    TimedCloseDisplay,
+    TimedGetDVCInfo,
+    TimedGetDVCRange,
+    TimedSetDVCLevel,
+    TimedGetHueInfo,
+    TimedSetHueAngle,
+    TimedGetGammaRamp,
+    TimedSetGammaRamp,
+};
+
+/*
+ * Wrap a backend in the timing shim
+ */
+const DisplayBackend* GetTimedBackend(const DisplayBackend* backend) {
+    inner = backend;
+    timedBackend.name = backend->name;
+    return &timedBackend;
+}
@@ -0,0 +1,42 @@
+/*
+ * NVCP Toggle - Base ramp store
+ *
+ * A slot file with one BaseRamp per display index. It has no key and is
+ * not tied to a boot: the profile fingerprint in each entry stays valid
+ * across config changes.
+ */
+
+#include "nvcp_base_ramp.h"
+
+#define BASE_RAMP_MAGIC   0x5242564Eu  /* "NVBR" */
+#define BASE_RAMP_VERSION 3
+
+/*
+ * Open (or create) the store
+ */
+bool OpenBaseRampStore(const char* path, BaseRampStore* store) {
+    SlotFileFormat format = { BASE_RAMP_MAGIC, BASE_RAMP_VERSION, BASE_RAMP_MAX_DISPLAYS,
+                              sizeof(BaseRamp), 0, false };
+    return OpenSlotFile(path, &format, &store->slots);
+}
+
+/*
+ * Unmap the store
+ */
+void CloseBaseRampStore(BaseRampStore* store) {
+    CloseSlotFile(&store->slots);
+}
+
+/*
+ * Base ramp captured for the display at index
+ */
+bool ReadBaseRamp(const BaseRampStore* store, int index, const char* name, BaseRamp* base) {
+    return ReadSlot(&store->slots, index, name, base);
+}
+
+/*
+ * Record the base ramp of the display at index and what is composed on it
+ */
+void WriteBaseRamp(BaseRampStore* store, int index, const char* name, const BaseRamp* base) {
+    WriteSlot(&store->slots, index, name, base);
+}
@@ -0,0 +1,53 @@
+/*
+ * NVCP Toggle - Base ramp store
+ * Memory-mapped record of the ramp each display had before this tool first
+ * wrote to it (a calibration loader's or night-light tool's), so compose
+ * mode can apply profiles on top of it and put it back when toggling off.
+ */
+
+#ifndef NVCP_BASE_RAMP_H
+#define NVCP_BASE_RAMP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nvcp_ramp.h"
+#include "nvcp_slot_file.h"
+
+#define BASE_RAMP_FILE_NAME    "native_nvcp_base_ramps.bin"
+#define BASE_RAMP_MAX_DISPLAYS 32
+
+/* What the store keeps per display */
+typedef struct {
+    GammaRamp ramp;    /* The display's own ramp */
+    uint64_t applied;  /* GetProfileFingerprint of the profile last composed on it, 0 = none */
+} BaseRamp;
+
+typedef struct {
+    SlotFile slots;
+} BaseRampStore;
+
+/*
+ * Open (or create) the store. A file with the wrong magic, version or
+ * layout is reset to empty. Unlike the state journal it survives reboots:
+ * the loader that set a base ramp sets it again at login.
+ */
+bool OpenBaseRampStore(const char* path, BaseRampStore* store);
+
+/*
+ * Unmap the store; entries are written through the mapping
+ */
+void CloseBaseRampStore(BaseRampStore* store);
+
+/*
+ * Base ramp captured for the display at index, if it was captured from a
+ * display of that name and the entry is whole
+ */
+bool ReadBaseRamp(const BaseRampStore* store, int index, const char* name, BaseRamp* base);
+
+/*
+ * Record the base ramp of the display at index and what is composed on it
+ */
+void WriteBaseRamp(BaseRampStore* store, int index, const char* name, const BaseRamp* base);
+
+#endif /* NVCP_BASE_RAMP_H */
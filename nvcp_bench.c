@@ -0,0 +1,644 @@
+/*
+ * NVCP Toggle - Benchmarks
+ * Usage: nvcp_bench [--reps=N] [--warmup=N] [--json=file] [benchmark...]
+ *   (no benchmark names runs everything)
+ *
+ * Every measurement is calibrated to a batch of operations taking at least a
+ * millisecond, run for warmup batches, then timed over repeated batches and
+ * reported as mean, relative standard deviation, min and median ns/op.
+ * --json writes the same results for comparing runs.
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_backend.h"
+#include "nvcp_config.h"
+#include "nvcp_config_blob.h"
+#include "nvcp_lut.h"
+#include "nvcp_platform.h"
+#include "nvcp_ramp.h"
+#include "nvcp_ramp_cache.h"
+#include "nvcp_toggle.h"
+
+#define BENCH_CACHE_FILE "nvcp_bench_ramps.cache"
+#define BENCH_CONFIG_FILE "nvcp_bench_config.ini"
+#define BENCH_BLOB_FILE   "nvcp_bench_config.bin"
+
+#define BENCH_NAME_SIZE    96
+#define BENCH_MAX_RESULTS  128
+#define BENCH_MAX_REPS     1000
+#define BENCH_MIN_BATCH_NS 1000000ull  /* Calibrate batches to at least 1 ms */
+#define BENCH_MAX_BATCH    (1l << 26)
+
+/* Runs an operation ops times */
+typedef void (*BenchOp)(void* arg, long ops);
+
+/* Per-operation timings of one measurement, in ns */
+typedef struct {
+    char name[BENCH_NAME_SIZE];
+    long opsPerRep;
+    double mean;
+    double stddev;
+    double min;
+    double median;
+    double max;
+} BenchResult;
+
+static int warmupReps = 3;
+static int measureReps = 15;
+static BenchResult results[BENCH_MAX_RESULTS];
+static int resultCount = 0;
+
+/* Results are folded in here so the compiler cannot drop the work */
+static volatile uint64_t benchSink;
+
+static uint64_t TimeBatch(BenchOp op, void* arg, long ops) {
+    uint64_t start = GetMonotonicNs();
+    op(arg, ops);
+    return GetMonotonicNs() - start;
+}
+
+static int CompareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Calibrate, warm up and time an operation, then record and print the
+ * result under a printf-style name
+ */
+static void Measure(BenchOp op, void* arg, const char* nameFormat, ...) {
+    static double samples[BENCH_MAX_REPS];
+    if (resultCount >= BENCH_MAX_RESULTS) return;
+    BenchResult* result = &results[resultCount++];
+
+    va_list args;
+    va_start(args, nameFormat);
+    vsnprintf(result->name, sizeof(result->name), nameFormat, args);
+    va_end(args);
+
+    long ops = 1;
+    while (ops < BENCH_MAX_BATCH && TimeBatch(op, arg, ops) < BENCH_MIN_BATCH_NS) {
+        ops *= 2;
+    }
+    for (int r = 0; r < warmupReps; r++) {
+        TimeBatch(op, arg, ops);
+    }
+
+    double sum = 0;
+    for (int r = 0; r < measureReps; r++) {
+        samples[r] = (double)TimeBatch(op, arg, ops) / ops;
+        sum += samples[r];
+    }
+    result->opsPerRep = ops;
+    result->mean = sum / measureReps;
+
+    double squares = 0;
+    for (int r = 0; r < measureReps; r++) {
+        squares += (samples[r] - result->mean) * (samples[r] - result->mean);
+    }
+    result->stddev = measureReps > 1 ? sqrt(squares / (measureReps - 1)) : 0;
+
+    qsort(samples, (size_t)measureReps, sizeof(samples[0]), CompareDoubles);
+    result->min = samples[0];
+    result->max = samples[measureReps - 1];
+    result->median = (measureReps % 2) ? samples[measureReps / 2]
+                   : (samples[measureReps / 2 - 1] + samples[measureReps / 2]) / 2;
+
+    printf("  %-52s %12.1f ns/op  +-%5.1f%%  min %12.1f  median %12.1f\n", result->name, result->mean,
+           result->mean > 0 ? 100.0 * result->stddev / result->mean : 0.0, result->min, result->median);
+    fflush(stdout);
+}
+
+/*
+ * Write every recorded result as JSON
+ */
+static bool WriteResultsJson(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+
+    fprintf(f, "{\n  \"kernel\": \"%s\",\n  \"warmup\": %d,\n  \"repetitions\": %d,\n  \"results\": [",
+            GetGammaRampKernelName(), warmupReps, measureReps);
+    for (int i = 0; i < resultCount; i++) {
+        const BenchResult* r = &results[i];
+        fprintf(f, "%s\n    {\"name\": \"%s\", \"ops_per_rep\": %ld, \"mean_ns\": %.3f, \"stddev_ns\": %.3f, "
+                   "\"min_ns\": %.3f, \"median_ns\": %.3f, \"max_ns\": %.3f}",
+                i ? "," : "", r->name, r->opsPerRep, r->mean, r->stddev, r->min, r->median, r->max);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+/* Inputs of one BuildGammaRamp call */
+typedef struct {
+    double brightness;
+    double contrast;
+    double gamma;
+    int temperature;
+    GammaRamp ramp;
+} RampBuildArgs;
+
+static void OpBuildGammaRamp(void* arg, long ops) {
+    RampBuildArgs* a = (RampBuildArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        BuildGammaRamp(&a->ramp, a->brightness, a->contrast, a->gamma, a->temperature);
+    }
+    benchSink += a->ramp.ch[0][128];
+}
+
+/*
+ * BuildGammaRamp with each available kernel: identity, a plain gamma curve,
+ * gamma with warm temperature, a cool, low-gamma curve, and a 3450 K white
+ * point (between two blackbody table rows)
+ */
+static void BenchRampBuild(void) {
+    static const char* kernels[] = { "reference", "fixed", "sse2", "avx2", "neon" };
+    static RampBuildArgs inputs[] = {
+        { 0.50, 0.50, 1.00, 0, {{{0}}} },
+        { 0.50, 0.55, 2.19, 0, {{{0}}} },
+        { 0.60, 0.65, 1.43, 50, {{{0}}} },
+        { 0.40, 0.60, 0.70, -100, {{{0}}} },
+        { 0.50, 0.55, 2.19, 3450, {{{0}}} },
+    };
+
+    printf("ramp_build\n");
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!SetGammaRampKernel(kernels[k])) continue;
+        for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+            RampBuildArgs* in = &inputs[i];
+            Measure(OpBuildGammaRamp, in, "ramp_build/%s/b%.2f_c%.2f_g%.2f_t%d", kernels[k],
+                    in->brightness, in->contrast, in->gamma, in->temperature);
+        }
+    }
+    SetGammaRampKernel("auto");
+}
+
+static GammaRamp1024 hiresRamp1024;  /* Large; keep them off the stack */
+static GammaRamp4096 hiresRamp4096;
+
+static void OpBuildGammaRamp1024(void* arg, long ops) {
+    const RampBuildArgs* a = (const RampBuildArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        BuildGammaRamp1024(&hiresRamp1024, a->brightness, a->contrast, a->gamma, a->temperature);
+    }
+    benchSink += hiresRamp1024.ch[0][512];
+}
+
+static void OpBuildGammaRamp4096(void* arg, long ops) {
+    const RampBuildArgs* a = (const RampBuildArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        BuildGammaRamp4096(&hiresRamp4096, a->brightness, a->contrast, a->gamma, a->temperature);
+    }
+    benchSink += hiresRamp4096.ch[0][2048];
+}
+
+static void OpDownsample1024(void* arg, long ops) {
+    GammaRamp* out = (GammaRamp*)arg;
+    for (long i = 0; i < ops; i++) {
+        DownsampleGammaRamp1024(&hiresRamp1024, out);
+    }
+    benchSink += out->ch[0][128];
+}
+
+static void OpDownsample4096(void* arg, long ops) {
+    GammaRamp* out = (GammaRamp*)arg;
+    for (long i = 0; i < ops; i++) {
+        DownsampleGammaRamp4096(&hiresRamp4096, out);
+    }
+    benchSink += out->ch[0][128];
+}
+
+/*
+ * High-resolution ramps with each available kernel, and resampling them to
+ * the 256-entry device ramp
+ */
+static void BenchRampHires(void) {
+    static const char* kernels[] = { "reference", "sse2", "avx2", "neon" };
+    static RampBuildArgs input = { 0.50, 0.55, 2.19, 0, {{{0}}} };
+
+    printf("ramp_hires\n");
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!SetGammaRampKernel(kernels[k])) continue;
+        Measure(OpBuildGammaRamp1024, &input, "ramp_hires/%s/build1024", kernels[k]);
+        Measure(OpBuildGammaRamp4096, &input, "ramp_hires/%s/build4096", kernels[k]);
+    }
+    SetGammaRampKernel("auto");
+
+    static GammaRamp out;
+    Measure(OpDownsample1024, &out, "ramp_hires/downsample1024");
+    Measure(OpDownsample4096, &out, "ramp_hires/downsample4096");
+}
+
+/* Inputs and output of the ramp algebra benchmarks */
+typedef struct {
+    GammaRamp a;
+    GammaRamp b;
+    GammaRamp out;
+} LutArgs;
+
+static void OpComposeGammaRamps(void* arg, long ops) {
+    LutArgs* l = (LutArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        ComposeGammaRamps(&l->out, &l->a, &l->b);
+    }
+    benchSink += l->out.ch[0][128];
+}
+
+static void OpInvertGammaRamp(void* arg, long ops) {
+    LutArgs* l = (LutArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        benchSink += InvertGammaRamp(&l->out, &l->a);
+    }
+    benchSink += l->out.ch[0][128];
+}
+
+static void OpBlendGammaRamps(void* arg, long ops) {
+    LutArgs* l = (LutArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        BlendGammaRamps(&l->out, &l->a, &l->b, 0.3);
+    }
+    benchSink += l->out.ch[0][128];
+}
+
+static void OpScaleGammaRamp(void* arg, long ops) {
+    static const double scale[3] = { 1.05, 1.0, 0.9 };
+    static const double offset[3] = { 0.0, 0.01, -0.02 };
+    LutArgs* l = (LutArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        ScaleGammaRamp(&l->out, &l->a, scale, offset);
+    }
+    benchSink += l->out.ch[0][128];
+}
+
+/*
+ * Ramp algebra on a calibration-like curve and a profile ramp
+ */
+static void BenchLut(void) {
+    static LutArgs args;
+    BuildGammaRamp(&args.a, 0.50, 0.55, 2.19, 0);
+    BuildGammaRamp(&args.b, 0.60, 0.65, 1.43, 50);
+
+    printf("lut\n");
+    Measure(OpComposeGammaRamps, &args, "lut/compose");
+    Measure(OpInvertGammaRamp, &args, "lut/invert");
+    Measure(OpBlendGammaRamps, &args, "lut/blend");
+    Measure(OpScaleGammaRamp, &args, "lut/scale_offset");
+}
+
+static void OpIsDefaultGammaRamp(void* arg, long ops) {
+    const GammaRamp* ramp = (const GammaRamp*)arg;
+    uint64_t count = 0;
+    for (long i = 0; i < ops; i++) {
+        count += IsDefaultGammaRamp(ramp);
+    }
+    benchSink += count;
+}
+
+static void OpHasDefaultGammaRamp(void* arg, long ops) {
+    const Display* display = (const Display*)arg;
+    uint64_t count = 0;
+    for (long i = 0; i < ops; i++) {
+        count += HasDefaultGammaRamp(GetStubBackend(), display, NULL);
+    }
+    benchSink += count;
+}
+
+/*
+ * The default-ramp check on the default ramp (every entry compared) and on
+ * custom ramps that differ early and only in the last entry, alone and with
+ * the ramp read through the stub backend
+ */
+static void BenchRampCompare(void) {
+    static GammaRamp custom, lastDiffers;
+    BuildGammaRamp(&custom, 0.5, 0.55, 2.19, 0);
+    lastDiffers = DefaultGammaRamp;
+    lastDiffers.ch[2][255] ^= 0x0100;
+
+    printf("ramp_compare\n");
+    Measure(OpIsDefaultGammaRamp, (void*)&DefaultGammaRamp, "ramp_compare/IsDefaultGammaRamp/default");
+    Measure(OpIsDefaultGammaRamp, &custom, "ramp_compare/IsDefaultGammaRamp/custom");
+    Measure(OpIsDefaultGammaRamp, &lastDiffers, "ramp_compare/IsDefaultGammaRamp/last_entry_differs");
+
+    const DisplayBackend* backend = GetStubBackend();
+    Display display;
+    StubBackendReset(1);
+    if (!backend->OpenDisplay(0, &display)) return;
+    Measure(OpHasDefaultGammaRamp, &display, "ramp_compare/HasDefaultGammaRamp/stub_default");
+    backend->SetGammaRamp(&display, &custom);
+    Measure(OpHasDefaultGammaRamp, &display, "ramp_compare/HasDefaultGammaRamp/stub_custom");
+    backend->CloseDisplay(&display);
+}
+
+/* Sweeps percent 50-100 for every dvcMax 1-255 */
+static void OpPercentToDVC(void* arg, long ops) {
+    (void)arg;
+    uint64_t sum = 0;
+    int percent = 50, dvcMax = 1;
+    for (long i = 0; i < ops; i++) {
+        sum += (uint64_t)PercentToDVC(percent, dvcMax);
+        if (++percent > 100) {
+            percent = 50;
+            if (++dvcMax > 255) dvcMax = 1;
+        }
+    }
+    benchSink += sum;
+}
+
+/* Sweeps every raw value 0-dvcMax for every dvcMax 1-255 */
+static void OpDVCToPercent(void* arg, long ops) {
+    (void)arg;
+    uint64_t sum = 0;
+    int value = 0, dvcMax = 1;
+    for (long i = 0; i < ops; i++) {
+        sum += (uint64_t)DVCToPercent(value, dvcMax);
+        if (++value > dvcMax) {
+            value = 0;
+            if (++dvcMax > 255) dvcMax = 1;
+        }
+    }
+    benchSink += sum;
+}
+
+/*
+ * Vibrance conversions, per call, across the whole dvcMax range
+ */
+static void BenchDvcConvert(void) {
+    printf("dvc_convert\n");
+    Measure(OpPercentToDVC, NULL, "dvc_convert/PercentToDVC");
+    Measure(OpDVCToPercent, NULL, "dvc_convert/DVCToPercent");
+}
+
+/* Ramp cache inputs and the scratch ramp a miss builds into */
+typedef struct {
+    RampCache cache;
+    GammaRamp scratch;
+} RampCacheArgs;
+
+static void OpRampCacheCold(void* arg, long ops) {
+    RampCacheArgs* a = (RampCacheArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        remove(BENCH_CACHE_FILE);
+        OpenRampCache(BENCH_CACHE_FILE, &a->cache);
+        RampCacheGetOrBuild(&a->cache, 0.5, 0.55, 2.19, 0, &a->scratch);
+        CloseRampCache(&a->cache);
+    }
+}
+
+static void OpRampCacheWarm(void* arg, long ops) {
+    RampCacheArgs* a = (RampCacheArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        OpenRampCache(BENCH_CACHE_FILE, &a->cache);
+        benchSink += RampCacheGetOrBuild(&a->cache, 0.5, 0.55, 2.19, 0, &a->scratch)->ch[0][128];
+        CloseRampCache(&a->cache);
+    }
+}
+
+static void OpRampCacheLookup(void* arg, long ops) {
+    RampCacheArgs* a = (RampCacheArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        benchSink += RampCacheGetOrBuild(&a->cache, 0.5, 0.55, 2.19, 0, &a->scratch)->ch[0][128];
+    }
+}
+
+/*
+ * Startup cost of getting the custom ramp: cold (no cache file, build and
+ * store), warm (open the mapped file and look the ramp up), and lookup with
+ * the file already mapped, as a resident process sees it
+ */
+static void BenchRampCacheWithKernel(const char* kernel) {
+    static RampCacheArgs args;
+    if (!SetGammaRampKernel(kernel)) return;
+    const char* name = GetGammaRampKernelName();
+
+    Measure(OpRampCacheCold, &args, "ramp_cache/%s/cold", name);
+    Measure(OpRampCacheWarm, &args, "ramp_cache/%s/warm", name);
+
+    OpenRampCache(BENCH_CACHE_FILE, &args.cache);
+    Measure(OpRampCacheLookup, &args, "ramp_cache/%s/lookup", name);
+    CloseRampCache(&args.cache);
+    remove(BENCH_CACHE_FILE);
+}
+
+static void BenchRampCache(void) {
+    printf("ramp_cache\n");
+    BenchRampCacheWithKernel("reference");
+    BenchRampCacheWithKernel("auto");
+}
+
+/*
+ * The fgets/sscanf/strcmp-chain loader LoadConfig replaced, kept as a baseline
+ */
+static bool LoadConfigLineByLine(const char* filename, Config* config) {
+    SetDefaultConfig(config);
+
+    FILE* f = fopen(filename, "r");
+    if (!f) return false;
+
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+
+        char key[64], value[64];
+        if (sscanf(line, "%63[^=]=%63s", key, value) == 2) {
+            char* k = key;
+            while (*k == ' ' || *k == '\t') k++;
+            char* v = value;
+            while (*v == ' ' || *v == '\t') v++;
+
+            if (strcmp(k, "toggleAllDisplays") == 0) {
+                config->toggleAllDisplays = (strcmp(v, "true") == 0 || strcmp(v, "1") == 0);
+            } else if (strcmp(k, "keyPressToExit") == 0) {
+                config->keyPressToExit = (strcmp(v, "true") == 0 || strcmp(v, "1") == 0);
+            } else if (strcmp(k, "vibrance") == 0) {
+                config->vibrance = atoi(v);
+            } else if (strcmp(k, "hue") == 0) {
+                config->hue = atoi(v);
+            } else if (strcmp(k, "brightness") == 0) {
+                config->brightness = atof(v);
+            } else if (strcmp(k, "contrast") == 0) {
+                config->contrast = atof(v);
+            } else if (strcmp(k, "gamma") == 0) {
+                config->gamma = atof(v);
+            } else if (strcmp(k, "temperature") == 0) {
+                config->temperature = atoi(v);
+            }
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+/*
+ * Write a config file with the global settings followed by profileCount
+ * [profile.N] sections, each a commented copy of every setting
+ */
+static size_t WriteBenchConfig(const char* path, int profileCount) {
+    FILE* f = fopen(path, "w");
+    if (!f) return 0;
+
+    fprintf(f, "# Benchmark config\ntoggleAllDisplays=false\nkeyPressToExit=false\n"
+               "vibrance=60\nhue=7\nbrightness=0.50\ncontrast=0.55\ngamma=2.19\ntemperature=0\n");
+    for (int i = 0; i < profileCount; i++) {
+        fprintf(f, "\n[profile.%d]\n# Settings for profile %d\n"
+                   "vibrance=%d\nhue=%d\nbrightness=0.%02d\ncontrast=0.%02d\ngamma=%d.%02d\n"
+                   "temperature=%d\nrampEngine=auto\n",
+                i, i, 50 + i % 50, i % 360, i % 100, (i * 7) % 100, 1 + i % 3, i % 100, i % 201 - 100);
+    }
+
+    long size = ftell(f);
+    fclose(f);
+    return size > 0 ? (size_t)size : 0;
+}
+
+/* A config file path and the config it loads into */
+typedef struct {
+    const char* path;
+    Config config;
+    GammaRamp ramp;
+    CompiledConfig compiled;
+} ConfigArgs;
+
+static void OpLoadConfig(void* arg, long ops) {
+    ConfigArgs* a = (ConfigArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        LoadConfig(a->path, &a->config);
+    }
+    benchSink += (uint64_t)a->config.profileCount;
+}
+
+static void OpLoadConfigLineByLine(void* arg, long ops) {
+    ConfigArgs* a = (ConfigArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        LoadConfigLineByLine(a->path, &a->config);
+    }
+    benchSink += (uint64_t)a->config.vibrance;
+}
+
+static void OpLoadCompiledConfig(void* arg, long ops) {
+    ConfigArgs* a = (ConfigArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        LoadCompiledConfig(BENCH_BLOB_FILE, a->path, &a->compiled);
+    }
+    benchSink += a->compiled.customRamp.ch[0][128];
+}
+
+static void OpParseAndBuildRamp(void* arg, long ops) {
+    ConfigArgs* a = (ConfigArgs*)arg;
+    for (long i = 0; i < ops; i++) {
+        LoadConfig(a->path, &a->config);
+        BuildGammaRamp(&a->ramp, a->config.brightness, a->config.contrast, a->config.gamma,
+                       a->config.temperature);
+    }
+    benchSink += a->ramp.ch[0][128];
+}
+
+/*
+ * LoadConfig against the line-by-line loader it replaced, on the shipped
+ * config size and on large multi-profile files
+ */
+static void BenchConfig(void) {
+    static const int profileCounts[] = { 0, 100, 10000 };
+    static ConfigArgs args;
+    args.path = BENCH_CONFIG_FILE;
+
+    printf("config\n");
+    for (size_t p = 0; p < sizeof(profileCounts) / sizeof(profileCounts[0]); p++) {
+        size_t size = WriteBenchConfig(BENCH_CONFIG_FILE, profileCounts[p]);
+        Measure(OpLoadConfig, &args, "config/LoadConfig/%d_profiles_%zu_bytes", profileCounts[p], size);
+        Measure(OpLoadConfigLineByLine, &args, "config/line_by_line/%d_profiles_%zu_bytes",
+                profileCounts[p], size);
+    }
+    remove(BENCH_CONFIG_FILE);
+}
+
+/*
+ * Startup config load: the compiled blob (stamp, content hash, one read)
+ * against parsing the text and building the custom ramp
+ */
+static void BenchConfigBlob(void) {
+    static const int profileCounts[] = { 0, 100 };
+    static ConfigArgs args;
+    args.path = BENCH_CONFIG_FILE;
+    CompiledConfig* compiled = &args.compiled;
+
+    printf("config_blob\n");
+    for (size_t p = 0; p < sizeof(profileCounts) / sizeof(profileCounts[0]); p++) {
+        size_t size = WriteBenchConfig(BENCH_CONFIG_FILE, profileCounts[p]);
+        LoadConfig(BENCH_CONFIG_FILE, &compiled->config);
+        BuildGammaRamp(&compiled->customRamp, compiled->config.brightness, compiled->config.contrast,
+                       compiled->config.gamma, compiled->config.temperature);
+        snprintf(compiled->kernel, sizeof(compiled->kernel), "%s", GetGammaRampKernelName());
+        if (!SaveCompiledConfig(BENCH_BLOB_FILE, BENCH_CONFIG_FILE, compiled)) break;
+
+        Measure(OpLoadCompiledConfig, &args, "config_blob/compiled/%d_profiles_%zu_bytes",
+                profileCounts[p], size);
+        Measure(OpParseAndBuildRamp, &args, "config_blob/parse_and_build/%d_profiles_%zu_bytes",
+                profileCounts[p], size);
+    }
+    remove(BENCH_BLOB_FILE);
+    remove(BENCH_CONFIG_FILE);
+}
+
+typedef struct {
+    const char* name;
+    void (*run)(void);
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+    { "ramp_build", BenchRampBuild },
+    { "ramp_hires", BenchRampHires },
+    { "ramp_compare", BenchRampCompare },
+    { "lut", BenchLut },
+    { "dvc_convert", BenchDvcConvert },
+    { "ramp_cache", BenchRampCache },
+    { "config", BenchConfig },
+    { "config_blob", BenchConfigBlob },
+};
+
+#define BENCHMARK_COUNT (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+int main(int argc, char* argv[]) {
+    const char* jsonPath = NULL;
+    bool selected[BENCHMARK_COUNT] = { false };
+    bool anySelected = false;
+
+    for (int a = 1; a < argc; a++) {
+        if (strncmp(argv[a], "--json=", 7) == 0) {
+            jsonPath = argv[a] + 7;
+        } else if (strncmp(argv[a], "--reps=", 7) == 0) {
+            measureReps = atoi(argv[a] + 7);
+        } else if (strncmp(argv[a], "--warmup=", 9) == 0) {
+            warmupReps = atoi(argv[a] + 9);
+        } else {
+            size_t i = 0;
+            while (i < BENCHMARK_COUNT && strcmp(argv[a], benchmarks[i].name) != 0) i++;
+            if (i == BENCHMARK_COUNT) {
+                printf("Unknown benchmark: %s\n", argv[a]);
+                return 1;
+            }
+            selected[i] = anySelected = true;
+        }
+    }
+    if (measureReps < 1) measureReps = 1;
+    if (measureReps > BENCH_MAX_REPS) measureReps = BENCH_MAX_REPS;
+    if (warmupReps < 0) warmupReps = 0;
+
+    SetGammaRampKernel("auto");
+    printf("nvcp_bench: kernel %s, %d warmup + %d timed batches per measurement\n",
+           GetGammaRampKernelName(), warmupReps, measureReps);
+
+    for (size_t i = 0; i < BENCHMARK_COUNT; i++) {
+        if (!anySelected || selected[i]) benchmarks[i].run();
+    }
+
+    if (jsonPath && !WriteResultsJson(jsonPath)) {
+        printf("Could not write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,354 @@
+/*
+ * NVCP Toggle - End-to-end toggle benchmark
+ * Runs the toggle flow against the stand-in backend with a simulated driver
+ * cost model, for 1 to 16 displays, and reports toggle latency percentiles.
+ *
+ * Usage: nvcp_bench_toggle [options]
+ *   --displays=1,2,4,8,16  display counts to run
+ *   --runs=N               timed toggles per display count (default 100)
+ *   --mode=process|daemon|both
+ *                          process: a full in-process run (initialize, open
+ *                          displays, start workers, toggle, close, unload);
+ *                          daemon: the toggle alone, with everything kept open
+ *   --workers=N            as the workers config key (0 = one per display)
+ *   --sync                 one decision for all displays (syncDisplays=true)
+ *   --journal              decide from a state journal instead of reading displays back
+ *   --init-us=N --open-us=N --read-us=N --write-us=N --ramp-read-us=N --ramp-write-us=N
+ *                          simulated cost of each kind of driver call
+ *   --jitter=F             each call varies uniformly by +-F of its cost
+ *   --failure-rate=F       chance each display read or write fails
+ *   --json=file            also write the results as JSON
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_backend.h"
+#include "nvcp_config.h"
+#include "nvcp_journal.h"
+#include "nvcp_output.h"
+#include "nvcp_platform.h"
+#include "nvcp_profile.h"
+#include "nvcp_ramp.h"
+#include "nvcp_thread.h"
+#include "nvcp_toggle.h"
+
+#define BENCH_JOURNAL_FILE "nvcp_bench_state.bin"
+
+#define MAX_RUNS          100000
+#define WARMUP_RUNS       2
+#define MAX_DISPLAY_SIZES 16
+
+typedef enum {
+    MODE_PROCESS,
+    MODE_DAEMON,
+    MODE_COUNT
+} RunMode;
+
+static const char* modeNames[MODE_COUNT] = { "process", "daemon" };
+
+/* Latency distribution and driver work of one display count and mode */
+typedef struct {
+    RunMode mode;
+    int displays;
+    int runs;
+    double meanMs;
+    double p50Ms;
+    double p99Ms;
+    double maxMs;
+    double writesPerToggle;
+    unsigned failedCalls;
+} ToggleResult;
+
+static ToggleResult results[MAX_DISPLAY_SIZES * MODE_COUNT];
+static int resultCount = 0;
+
+static int CompareUint64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Nearest-rank percentile of sorted samples, in ms
+ */
+static double PercentileMs(const uint64_t* sorted, int count, double quantile) {
+    int rank = (int)ceil(quantile * count);
+    if (rank < 1) rank = 1;
+    return (double)sorted[rank - 1] / 1e6;
+}
+
+/*
+ * Driver writes and failed calls recorded by the stand-in so far
+ */
+static void GetStubTotals(int displays, unsigned* writes, unsigned* failed) {
+    *writes = 0;
+    *failed = 0;
+    for (int i = 0; i < displays; i++) {
+        const StubDisplay* d = StubBackendGetDisplay(i);
+        *writes += d->dvcWrites + d->hueWrites + d->rampWrites;
+        *failed += d->failedCalls;
+    }
+}
+
+/*
+ * One run of the tool as main does it once the config is loaded
+ */
+static uint64_t RunProcessToggle(ToggleContext* ctx) {
+    const DisplayBackend* backend = ctx->backend;
+    uint64_t start = GetMonotonicNs();
+
+    backend->Initialize();
+    backend->LoadExtensions();
+    DisplaySet displays;
+    OpenDisplaySet(backend, ctx->config->toggleAllDisplays, &displays);
+    int workerCount = GetToggleWorkerCount(ctx->config, &displays);
+    ctx->workers = (displays.allDisplays && workerCount > 1) ? CreateWorkerPool(workerCount) : NULL;
+
+    Output out;
+    OutputInit(&out);
+    ToggleDisplays(ctx, &displays, &out);
+    OutputFree(&out);
+
+    DestroyWorkerPool(ctx->workers);
+    ctx->workers = NULL;
+    CloseDisplaySet(backend, &displays);
+    backend->Unload();
+
+    return GetMonotonicNs() - start;
+}
+
+/*
+ * One toggle request served by a daemon that holds the displays open
+ */
+static uint64_t RunDaemonToggle(const ToggleContext* ctx, const DisplaySet* displays) {
+    uint64_t start = GetMonotonicNs();
+    Output out;
+    OutputInit(&out);
+    ToggleDisplays(ctx, displays, &out);
+    OutputFree(&out);
+    return GetMonotonicNs() - start;
+}
+
+/*
+ * Time runs toggles of displayCount displays in one mode
+ */
+static void BenchToggle(ToggleContext* ctx, RunMode mode, int displayCount, int runs) {
+    static uint64_t samples[MAX_RUNS];
+    const DisplayBackend* backend = ctx->backend;
+    DisplaySet displays;
+
+    StubBackendReset(displayCount);
+    if (ctx->journal) {
+        /* Start every display count from an empty journal */
+        CloseStateJournal(ctx->journal);
+        remove(BENCH_JOURNAL_FILE);
+        OpenStateJournal(BENCH_JOURNAL_FILE, HashProfileIndex(ctx->profiles), ctx->journal);
+    }
+    if (mode == MODE_DAEMON) {
+        backend->Initialize();
+        backend->LoadExtensions();
+        OpenDisplaySet(backend, ctx->config->toggleAllDisplays, &displays);
+        int workerCount = GetToggleWorkerCount(ctx->config, &displays);
+        ctx->workers = (displays.allDisplays && workerCount > 1) ? CreateWorkerPool(workerCount) : NULL;
+    }
+
+    unsigned writesBefore = 0, failedBefore = 0;
+    for (int i = -WARMUP_RUNS; i < runs; i++) {
+        if (i == 0) GetStubTotals(displayCount, &writesBefore, &failedBefore);
+        uint64_t ns = (mode == MODE_DAEMON) ? RunDaemonToggle(ctx, &displays) : RunProcessToggle(ctx);
+        if (i >= 0) samples[i] = ns;
+    }
+    unsigned writes, failed;
+    GetStubTotals(displayCount, &writes, &failed);
+
+    if (mode == MODE_DAEMON) {
+        DestroyWorkerPool(ctx->workers);
+        ctx->workers = NULL;
+        CloseDisplaySet(backend, &displays);
+        backend->Unload();
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < runs; i++) total += samples[i];
+    qsort(samples, (size_t)runs, sizeof(samples[0]), CompareUint64);
+
+    ToggleResult* r = &results[resultCount++];
+    r->mode = mode;
+    r->displays = displayCount;
+    r->runs = runs;
+    r->meanMs = (double)total / runs / 1e6;
+    r->p50Ms = PercentileMs(samples, runs, 0.50);
+    r->p99Ms = PercentileMs(samples, runs, 0.99);
+    r->maxMs = (double)samples[runs - 1] / 1e6;
+    r->writesPerToggle = (double)(writes - writesBefore) / runs;
+    r->failedCalls = failed - failedBefore;
+
+    printf("%-8s %8d %10.3f %10.3f %10.3f %10.3f %14.1f %8u\n", modeNames[mode], displayCount,
+           r->meanMs, r->p50Ms, r->p99Ms, r->maxMs, r->writesPerToggle, r->failedCalls);
+    fflush(stdout);
+}
+
+static bool WriteResultsJson(const char* path, const StubDriverModel* model, const Config* config, bool journal) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+
+    fprintf(f, "{\n  \"model\": {\"initialize_us\": %.1f, \"open_us\": %.1f, \"read_us\": %.1f, "
+               "\"write_us\": %.1f, \"ramp_read_us\": %.1f, \"ramp_write_us\": %.1f, "
+               "\"jitter\": %.3f, \"failure_rate\": %.4f},\n",
+            model->initializeNs / 1e3, model->openNs / 1e3, model->nvapiReadNs / 1e3,
+            model->nvapiWriteNs / 1e3, model->rampReadNs / 1e3, model->rampWriteNs / 1e3,
+            model->jitter, model->failureRate);
+    fprintf(f, "  \"workers\": %d,\n  \"sync_displays\": %s,\n  \"journal\": %s,\n  \"results\": [",
+            config->workers, config->syncDisplays ? "true" : "false", journal ? "true" : "false");
+    for (int i = 0; i < resultCount; i++) {
+        const ToggleResult* r = &results[i];
+        fprintf(f, "%s\n    {\"mode\": \"%s\", \"displays\": %d, \"runs\": %d, \"mean_ms\": %.4f, "
+                   "\"p50_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f, \"writes_per_toggle\": %.2f, "
+                   "\"failed_calls\": %u}",
+                i ? "," : "", modeNames[r->mode], r->displays, r->runs, r->meanMs, r->p50Ms, r->p99Ms,
+                r->maxMs, r->writesPerToggle, r->failedCalls);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    return fclose(f) == 0;
+}
+
+/*
+ * Parse a comma-separated list of display counts
+ */
+static int ParseDisplayCounts(const char* text, int* counts) {
+    int count = 0;
+    while (*text && count < MAX_DISPLAY_SIZES) {
+        int n = atoi(text);
+        if (n < 1 || n > STUB_MAX_DISPLAYS) return 0;
+        counts[count++] = n;
+        text = strchr(text, ',');
+        if (!text) break;
+        text++;
+    }
+    return count;
+}
+
+static uint64_t MicrosToNs(const char* text) {
+    double us = atof(text);
+    return us > 0 ? (uint64_t)(us * 1000.0) : 0;
+}
+
+int main(int argc, char* argv[]) {
+    /* Default costs in the range NVAPI and GDI calls take on real systems */
+    StubDriverModel model = {
+        .initializeNs = 5000000,
+        .openNs = 50000,
+        .nvapiReadNs = 30000,
+        .nvapiWriteNs = 300000,
+        .rampReadNs = 50000,
+        .rampWriteNs = 1000000,
+        .jitter = 0.2,
+        .failureRate = 0.0,
+    };
+    int displayCounts[MAX_DISPLAY_SIZES] = { 1, 2, 4, 8, 16 };
+    int displaySizes = 5;
+    int runs = 100;
+    bool modes[MODE_COUNT] = { true, true };
+    bool useJournal = false;
+    const char* jsonPath = NULL;
+
+    static Config config;  /* Large; keep it off the stack */
+    SetDefaultConfig(&config);
+    config.toggleAllDisplays = true;
+    config.keyPressToExit = false;
+    config.vibrance = 60;
+    config.gamma = 2.19;
+    config.contrast = 0.55;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--displays=", 11) == 0) {
+            displaySizes = ParseDisplayCounts(arg + 11, displayCounts);
+            if (displaySizes == 0) {
+                printf("Display counts must be 1-%d\n", STUB_MAX_DISPLAYS);
+                return 1;
+            }
+        } else if (strncmp(arg, "--runs=", 7) == 0) {
+            runs = atoi(arg + 7);
+        } else if (strcmp(arg, "--mode=process") == 0) {
+            modes[MODE_DAEMON] = false;
+        } else if (strcmp(arg, "--mode=daemon") == 0) {
+            modes[MODE_PROCESS] = false;
+        } else if (strcmp(arg, "--mode=both") == 0) {
+            modes[MODE_PROCESS] = modes[MODE_DAEMON] = true;
+        } else if (strncmp(arg, "--workers=", 10) == 0) {
+            config.workers = atoi(arg + 10);
+        } else if (strcmp(arg, "--sync") == 0) {
+            config.syncDisplays = true;
+        } else if (strcmp(arg, "--journal") == 0) {
+            useJournal = true;
+        } else if (strncmp(arg, "--init-us=", 10) == 0) {
+            model.initializeNs = MicrosToNs(arg + 10);
+        } else if (strncmp(arg, "--open-us=", 10) == 0) {
+            model.openNs = MicrosToNs(arg + 10);
+        } else if (strncmp(arg, "--read-us=", 10) == 0) {
+            model.nvapiReadNs = MicrosToNs(arg + 10);
+        } else if (strncmp(arg, "--write-us=", 11) == 0) {
+            model.nvapiWriteNs = MicrosToNs(arg + 11);
+        } else if (strncmp(arg, "--ramp-read-us=", 15) == 0) {
+            model.rampReadNs = MicrosToNs(arg + 15);
+        } else if (strncmp(arg, "--ramp-write-us=", 16) == 0) {
+            model.rampWriteNs = MicrosToNs(arg + 16);
+        } else if (strncmp(arg, "--jitter=", 9) == 0) {
+            model.jitter = atof(arg + 9);
+        } else if (strncmp(arg, "--failure-rate=", 15) == 0) {
+            model.failureRate = atof(arg + 15);
+        } else if (strncmp(arg, "--json=", 7) == 0) {
+            jsonPath = arg + 7;
+        } else {
+            printf("Unknown option: %s\n", arg);
+            return 1;
+        }
+    }
+    if (runs < 1) runs = 1;
+    if (runs > MAX_RUNS) runs = MAX_RUNS;
+
+    /* The toggle moves between defaults and the custom profile, as main sets it up */
+    static ProfileIndex profiles;  /* Large; keep it off the stack */
+    GammaRamp customRamp;
+    Profile customProfile;
+    SetGammaRampKernel("auto");
+    BuildGammaRamp(&customRamp, config.brightness, config.contrast, config.gamma, config.temperature);
+    InitProfileIndex(&profiles);
+    GetCustomProfile(&config, &customProfile);
+    AddProfile(&profiles, &customProfile, &customRamp);
+
+    ToggleContext ctx = { GetStubBackend(), &config, &profiles, NULL, false, NULL, NULL, NULL };
+    StateJournal journal = {0};
+    if (useJournal) ctx.journal = &journal;
+    StubBackendSetDriverModel(&model);
+
+    printf("Driver model (us): initialize %.0f, open %.0f, read %.0f, write %.0f, ramp read %.0f, "
+           "ramp write %.0f, jitter +-%.0f%%, failure rate %.2f%%\n",
+           model.initializeNs / 1e3, model.openNs / 1e3, model.nvapiReadNs / 1e3, model.nvapiWriteNs / 1e3,
+           model.rampReadNs / 1e3, model.rampWriteNs / 1e3, model.jitter * 100, model.failureRate * 100);
+    printf("workers=%d syncDisplays=%s journal=%s, %d runs after %d warmup\n\n", config.workers,
+           config.syncDisplays ? "true" : "false", useJournal ? "true" : "false", runs, WARMUP_RUNS);
+    printf("%-8s %8s %10s %10s %10s %10s %14s %8s\n", "mode", "displays", "mean ms", "p50 ms", "p99 ms",
+           "max ms", "writes/toggle", "failed");
+
+    for (int m = 0; m < MODE_COUNT; m++) {
+        if (!modes[m]) continue;
+        for (int d = 0; d < displaySizes; d++) {
+            BenchToggle(&ctx, (RunMode)m, displayCounts[d], runs);
+        }
+    }
+
+    StubBackendSetDriverModel(NULL);
+    if (useJournal) {
+        CloseStateJournal(&journal);
+        remove(BENCH_JOURNAL_FILE);
+    }
+    if (jsonPath && !WriteResultsJson(jsonPath, &model, &config, useJournal)) {
+        printf("Could not write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * NVCP Toggle - Driver capability cache
+ *
+ * Like the compiled config, the file is one fixed-layout struct read and
+ * written in one call, with a checksum over it. It is only valid for the
+ * driver version it was recorded with; a driver update starts it afresh.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nvcp_caps.h"
+#include "nvcp_hash.h"
+
+#define CAPS_MAGIC   0x5043564Eu  /* "NVCP" */
+#define CAPS_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t fileSize;    /* sizeof(CapsFile), changes with the layout */
+    uint32_t reserved;
+    DriverCaps caps;
+    uint64_t checksum;    /* Of everything above */
+} CapsFile;
+
+static uint64_t CapsChecksum(const CapsFile* file) {
+    return HashWords(FNV1A64_OFFSET, file, offsetof(CapsFile, checksum));
+}
+
+/*
+ * Load the cache recorded for driverVersion
+ */
+bool LoadDriverCaps(const char* path, uint32_t driverVersion, DriverCaps* caps) {
+    CapsFile file;
+
+    memset(caps, 0, sizeof(*caps));
+    caps->driverVersion = driverVersion;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    size_t read = fread(&file, 1, sizeof(file), f);
+    fclose(f);
+
+    if (read != sizeof(file) || file.magic != CAPS_MAGIC || file.version != CAPS_VERSION ||
+        file.fileSize != sizeof(CapsFile) || file.checksum != CapsChecksum(&file) ||
+        file.caps.driverVersion != driverVersion) {
+        return false;
+    }
+
+    *caps = file.caps;
+    return true;
+}
+
+/*
+ * Write the cache
+ */
+bool SaveDriverCaps(const char* path, const DriverCaps* caps) {
+    CapsFile file;
+
+    memset(&file, 0, sizeof(file));
+    file.magic = CAPS_MAGIC;
+    file.version = CAPS_VERSION;
+    file.fileSize = sizeof(CapsFile);
+    file.caps = *caps;
+    file.checksum = CapsChecksum(&file);
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(&file, sizeof(file), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) remove(path);
+    return ok;
+}
+
+/*
+ * Entry for the display at index, reset if recorded for another display
+ */
+DisplayCaps* ClaimDisplayCaps(DriverCaps* caps, int index, const char* name) {
+    DisplayCaps* display = GetDisplayCaps(caps, index);
+    if (!display) return NULL;
+
+    if (strncmp(display->name, name, sizeof(display->name)) != 0) {
+        memset(display, 0, sizeof(*display));
+        snprintf(display->name, sizeof(display->name), "%s", name);
+    }
+    return display;
+}
+
+/*
+ * Entry for the display at index
+ */
+DisplayCaps* GetDisplayCaps(DriverCaps* caps, int index) {
+    if (index < 0 || index >= CAPS_MAX_DISPLAYS) return NULL;
+    return &caps->displays[index];
+}
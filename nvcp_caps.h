@@ -0,0 +1,70 @@
+/*
+ * NVCP Toggle - Driver capability cache
+ * Which undocumented NVAPI entry points resolve, which calls a display does
+ * not support, and each display's DVC range, stored next to the executable
+ * per driver version so later runs skip calls that cannot succeed.
+ */
+
+#ifndef NVCP_CAPS_H
+#define NVCP_CAPS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nvcp_backend.h"
+
+#define CAPS_FILE_NAME    "native_nvcp_caps.bin"
+#define CAPS_MAX_DISPLAYS 32
+
+/* Undocumented calls tracked by the cache, one bit each */
+typedef enum {
+    CAP_GET_DVC_INFO,
+    CAP_SET_DVC_LEVEL,
+    CAP_GET_HUE_INFO,
+    CAP_SET_HUE_ANGLE,
+    CAP_COUNT
+} DriverCapability;
+
+#define CAP_BIT(cap) (1u << (cap))
+
+/* What is known about one display, by enumeration index */
+typedef struct {
+    char name[DISPLAY_NAME_SIZE];  /* Empty = nothing known */
+    int32_t dvcMin;
+    int32_t dvcMax;
+    uint8_t rangeKnown;
+    uint8_t unsupported;           /* CAP_BITs of calls the driver rejected as unsupported */
+    uint8_t reserved[2];
+} DisplayCaps;
+
+typedef struct {
+    uint32_t driverVersion;
+    uint32_t missing;              /* CAP_BITs of entry points that did not resolve */
+    DisplayCaps displays[CAPS_MAX_DISPLAYS];
+} DriverCaps;
+
+/*
+ * Load the cache recorded for driverVersion. On a miss (no file, another
+ * driver, a damaged file) caps is reset to an empty cache for driverVersion
+ * and false is returned.
+ */
+bool LoadDriverCaps(const char* path, uint32_t driverVersion, DriverCaps* caps);
+
+/*
+ * Write the cache
+ */
+bool SaveDriverCaps(const char* path, const DriverCaps* caps);
+
+/*
+ * Entry for the display at index, reset if it was recorded for another
+ * display name; NULL if index is out of range. Call while opening displays,
+ * before any concurrent use.
+ */
+DisplayCaps* ClaimDisplayCaps(DriverCaps* caps, int index, const char* name);
+
+/*
+ * Entry for the display at index, NULL if out of range
+ */
+DisplayCaps* GetDisplayCaps(DriverCaps* caps, int index);
+
+#endif /* NVCP_CAPS_H */
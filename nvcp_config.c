@@ -0,0 +1,415 @@
+/*
+ * NVCP Toggle - Configuration
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_config.h"
+#include "nvcp_platform.h"
+#include "nvcp_ramp.h"
+
+/*
+ * Fill in the built-in configuration used when no config file is available
+ */
+void SetDefaultConfig(Config* config) {
+    config->toggleAllDisplays = false;
+    config->keyPressToExit = true;
+    config->workers = 0;
+    config->syncDisplays = false;
+    config->gammaOnly = false;
+    config->fadeDuration = 0;
+    strcpy(config->fadeEase, "smooth");
+    config->vibrance = 80;
+    config->hue = 7;
+    config->brightness = 0.60;
+    config->contrast = 0.65;
+    config->gamma = 1.43;
+    config->temperature = 0;
+    config->composeRamps = false;
+    strcpy(config->rampEngine, "auto");
+    config->rampCache = false;
+    config->compiledConfig = true;
+    config->stateJournal = false;
+    config->cycleProfiles = false;
+    config->profileCount = 0;
+}
+
+/*
+ * The global custom settings as an unnamed profile
+ */
+void GetCustomProfile(const Config* config, Profile* profile) {
+    memset(profile, 0, sizeof(*profile));
+    profile->vibrance = config->vibrance;
+    profile->hue = config->hue;
+    profile->brightness = config->brightness;
+    profile->contrast = config->contrast;
+    profile->gamma = config->gamma;
+    profile->temperature = config->temperature;
+}
+
+/* Keys recognized in the config file */
+typedef enum {
+    KEY_NONE = 0,
+    KEY_TOGGLE_ALL_DISPLAYS,
+    KEY_KEY_PRESS_TO_EXIT,
+    KEY_SYNC_DISPLAYS,
+    KEY_GAMMA_ONLY,
+    KEY_FADE_DURATION,
+    KEY_FADE_EASE,
+    KEY_WORKERS,
+    KEY_VIBRANCE,
+    KEY_HUE,
+    KEY_BRIGHTNESS,
+    KEY_CONTRAST,
+    KEY_GAMMA,
+    KEY_TEMPERATURE,
+    KEY_TEMPERATURE_KELVIN,
+    KEY_COMPOSE_RAMPS,
+    KEY_RAMP_CACHE,
+    KEY_RAMP_ENGINE,
+    KEY_COMPILED_CONFIG,
+    KEY_STATE_JOURNAL,
+    KEY_CYCLE_PROFILES,
+} ConfigKey;
+
+typedef struct {
+    const char* name;
+    size_t length;
+    ConfigKey key;
+} ConfigKeySlot;
+
+/*
+ * Perfect hash over the key names: first char, last char and length pick a
+ * distinct slot for every key, so a lookup is one hash and one memcmp.
+ * The multiplier was found by searching offline. Slots are computed from
+ * the characters given with each key below, and two keys landing in one
+ * slot fail the build; FindMisplacedConfigKey checks the characters
+ * against the names.
+ */
+#define CONFIG_KEY_SLOTS 32
+#define CONFIG_KEY_HASH(first, last, length) \
+    (((unsigned)(first) + 3u * (unsigned)(last) + (unsigned)(length)) & (CONFIG_KEY_SLOTS - 1))
+
+/* Every key: first char, last char, name, id */
+#define CONFIG_KEYS(X) \
+    X('t', 'K', "temperatureK", KEY_TEMPERATURE_KELVIN) \
+    X('s', 'l', "stateJournal", KEY_STATE_JOURNAL) \
+    X('b', 's', "brightness", KEY_BRIGHTNESS) \
+    X('c', 'g', "compiledConfig", KEY_COMPILED_CONFIG) \
+    X('c', 't', "contrast", KEY_CONTRAST) \
+    X('c', 's', "composeRamps", KEY_COMPOSE_RAMPS) \
+    X('c', 's', "cycleProfiles", KEY_CYCLE_PROFILES) \
+    X('r', 'e', "rampCache", KEY_RAMP_CACHE) \
+    X('r', 'e', "rampEngine", KEY_RAMP_ENGINE) \
+    X('v', 'e', "vibrance", KEY_VIBRANCE) \
+    X('t', 'e', "temperature", KEY_TEMPERATURE) \
+    X('g', 'a', "gamma", KEY_GAMMA) \
+    X('k', 't', "keyPressToExit", KEY_KEY_PRESS_TO_EXIT) \
+    X('w', 's', "workers", KEY_WORKERS) \
+    X('s', 's', "syncDisplays", KEY_SYNC_DISPLAYS) \
+    X('h', 'e', "hue", KEY_HUE) \
+    X('g', 'y', "gammaOnly", KEY_GAMMA_ONLY) \
+    X('f', 'n', "fadeDuration", KEY_FADE_DURATION) \
+    X('f', 'e', "fadeEase", KEY_FADE_EASE) \
+    X('t', 's', "toggleAllDisplays", KEY_TOGGLE_ALL_DISPLAYS)
+
+#define KEY_SLOT_INDEX(first, last, str) CONFIG_KEY_HASH(first, last, sizeof(str) - 1)
+#define KEY_SLOT(first, last, str, id) [KEY_SLOT_INDEX(first, last, str)] = { str, sizeof(str) - 1, id },
+
+static const ConfigKeySlot configKeySlots[CONFIG_KEY_SLOTS] = {
+    CONFIG_KEYS(KEY_SLOT)
+};
+
+/* Distinct slots: the slot bits then add up to the same as they OR together */
+#define KEY_SLOT_BIT(first, last, str, id) + (1ull << KEY_SLOT_INDEX(first, last, str))
+#define KEY_SLOT_OR(first, last, str, id) | (1ull << KEY_SLOT_INDEX(first, last, str))
+_Static_assert((0 CONFIG_KEYS(KEY_SLOT_BIT)) == (0 CONFIG_KEYS(KEY_SLOT_OR)),
+               "two config keys hash to the same slot");
+
+/*
+ * Name of a config key whose slot does not match its name
+ */
+const char* FindMisplacedConfigKey(void) {
+    for (unsigned i = 0; i < CONFIG_KEY_SLOTS; i++) {
+        const ConfigKeySlot* slot = &configKeySlots[i];
+        if (slot->length == 0) continue;
+        if (CONFIG_KEY_HASH((unsigned char)slot->name[0], (unsigned char)slot->name[slot->length - 1],
+                            slot->length) != i) {
+            return slot->name;
+        }
+    }
+    return NULL;
+}
+
+/* A piece of the config text; not NUL-terminated */
+typedef struct {
+    const char* data;
+    size_t length;
+} TextSpan;
+
+static ConfigKey LookupConfigKey(TextSpan name) {
+    if (name.length == 0) return KEY_NONE;
+    const ConfigKeySlot* slot =
+        &configKeySlots[CONFIG_KEY_HASH((unsigned char)name.data[0], (unsigned char)name.data[name.length - 1],
+                                        name.length)];
+    if (slot->length == name.length && memcmp(slot->name, name.data, name.length) == 0) {
+        return slot->key;
+    }
+    return KEY_NONE;
+}
+
+static bool SpanEquals(TextSpan span, const char* str) {
+    size_t length = strlen(str);
+    return span.length == length && memcmp(span.data, str, length) == 0;
+}
+
+static bool ParseBool(TextSpan value) {
+    return SpanEquals(value, "true") || SpanEquals(value, "1");
+}
+
+/*
+ * Leading integer of a span, atoi-style (0 if there is none)
+ */
+static int ParseInt(TextSpan value) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < value.length && (value.data[i] == '-' || value.data[i] == '+')) {
+        negative = value.data[i] == '-';
+        i++;
+    }
+    long result = 0;
+    for (; i < value.length && value.data[i] >= '0' && value.data[i] <= '9'; i++) {
+        if (result < 1000000000L) result = result * 10 + (value.data[i] - '0');
+    }
+    return (int)(negative ? -result : result);
+}
+
+/*
+ * Leading number of a span, atof-style (0 if there is none)
+ */
+static double ParseDouble(TextSpan value) {
+    /* strtod needs a terminated string; numbers are short */
+    char buffer[64];
+    size_t length = value.length < sizeof(buffer) - 1 ? value.length : sizeof(buffer) - 1;
+    memcpy(buffer, value.data, length);
+    buffer[length] = '\0';
+    return atof(buffer);
+}
+
+/*
+ * Kelvin white point as the temperature field stores it
+ */
+static int ParseKelvin(TextSpan value) {
+    int kelvin = ParseInt(value);
+    if (kelvin < TEMPERATURE_MIN_KELVIN) kelvin = TEMPERATURE_MIN_KELVIN;
+    if (kelvin > TEMPERATURE_MAX_KELVIN) kelvin = TEMPERATURE_MAX_KELVIN;
+    return kelvin;
+}
+
+static void ApplyConfigValue(Config* config, ConfigKey key, TextSpan value) {
+    switch (key) {
+    case KEY_TOGGLE_ALL_DISPLAYS:
+        config->toggleAllDisplays = ParseBool(value);
+        break;
+    case KEY_KEY_PRESS_TO_EXIT:
+        config->keyPressToExit = ParseBool(value);
+        break;
+    case KEY_SYNC_DISPLAYS:
+        config->syncDisplays = ParseBool(value);
+        break;
+    case KEY_GAMMA_ONLY:
+        config->gammaOnly = ParseBool(value);
+        break;
+    case KEY_FADE_DURATION:
+        config->fadeDuration = ParseInt(value);
+        if (config->fadeDuration < 0) config->fadeDuration = 0;
+        if (config->fadeDuration > 5000) config->fadeDuration = 5000;
+        break;
+    case KEY_FADE_EASE:
+        snprintf(config->fadeEase, sizeof(config->fadeEase), "%.*s",
+                 (int)(value.length < sizeof(config->fadeEase) - 1 ? value.length : sizeof(config->fadeEase) - 1),
+                 value.data);
+        break;
+    case KEY_WORKERS:
+        config->workers = ParseInt(value);
+        if (config->workers < 0) config->workers = 0;
+        break;
+    case KEY_VIBRANCE:
+        config->vibrance = ParseInt(value);
+        break;
+    case KEY_HUE:
+        config->hue = ParseInt(value);
+        break;
+    case KEY_BRIGHTNESS:
+        config->brightness = ParseDouble(value);
+        break;
+    case KEY_CONTRAST:
+        config->contrast = ParseDouble(value);
+        break;
+    case KEY_GAMMA:
+        config->gamma = ParseDouble(value);
+        break;
+    case KEY_TEMPERATURE:
+        config->temperature = ParseInt(value);
+        /* Clamp to valid range */
+        if (config->temperature < -100) config->temperature = -100;
+        if (config->temperature > 100) config->temperature = 100;
+        break;
+    case KEY_TEMPERATURE_KELVIN:
+        config->temperature = ParseKelvin(value);
+        break;
+    case KEY_COMPOSE_RAMPS:
+        config->composeRamps = ParseBool(value);
+        break;
+    case KEY_RAMP_CACHE:
+        config->rampCache = ParseBool(value);
+        break;
+    case KEY_CYCLE_PROFILES:
+        config->cycleProfiles = ParseBool(value);
+        break;
+    case KEY_COMPILED_CONFIG:
+        config->compiledConfig = ParseBool(value);
+        break;
+    case KEY_STATE_JOURNAL:
+        config->stateJournal = ParseBool(value);
+        break;
+    case KEY_RAMP_ENGINE:
+        snprintf(config->rampEngine, sizeof(config->rampEngine), "%.*s",
+                 (int)(value.length < sizeof(config->rampEngine) - 1 ? value.length : sizeof(config->rampEngine) - 1),
+                 value.data);
+        break;
+    case KEY_NONE:
+        break;
+    }
+}
+
+/*
+ * Keys allowed in a [profile.NAME] section; the rest are ignored there
+ */
+static void ApplyProfileValue(Profile* profile, ConfigKey key, TextSpan value) {
+    switch (key) {
+    case KEY_VIBRANCE:
+        profile->vibrance = ParseInt(value);
+        break;
+    case KEY_HUE:
+        profile->hue = ParseInt(value);
+        break;
+    case KEY_BRIGHTNESS:
+        profile->brightness = ParseDouble(value);
+        break;
+    case KEY_CONTRAST:
+        profile->contrast = ParseDouble(value);
+        break;
+    case KEY_GAMMA:
+        profile->gamma = ParseDouble(value);
+        break;
+    case KEY_TEMPERATURE:
+        profile->temperature = ParseInt(value);
+        if (profile->temperature < -100) profile->temperature = -100;
+        if (profile->temperature > 100) profile->temperature = 100;
+        break;
+    case KEY_TEMPERATURE_KELVIN:
+        profile->temperature = ParseKelvin(value);
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * Start a profile for a [profile.NAME] header, NULL for any other section
+ * or once MAX_PROFILES are defined
+ */
+static Profile* BeginSection(Config* config, TextSpan header) {
+    static const char prefix[] = "profile.";
+    const size_t prefixLength = sizeof(prefix) - 1;
+
+    if (header.length <= prefixLength || memcmp(header.data, prefix, prefixLength) != 0) return NULL;
+    if (config->profileCount >= MAX_PROFILES) return NULL;
+
+    Profile* profile = &config->profiles[config->profileCount++];
+    GetCustomProfile(config, profile);
+    size_t nameLength = header.length - prefixLength;
+    if (nameLength > PROFILE_NAME_SIZE - 1) nameLength = PROFILE_NAME_SIZE - 1;
+    memcpy(profile->name, header.data + prefixLength, nameLength);
+    return profile;
+}
+
+static bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/*
+ * Parse config text in one pass without copying it
+ */
+void ParseConfigText(const char* text, size_t length, Config* config) {
+    const char* p = text;
+    const char* end = text + length;
+    bool inGlobalSection = true;
+    Profile* profile = NULL;  /* Section being read, NULL = global or skipped */
+
+    while (p < end) {
+        /* Line bounds, leading whitespace skipped */
+        while (p < end && IsBlank(*p)) p++;
+        const char* lineStart = p;
+        const char* lineEnd = memchr(p, '\n', (size_t)(end - p));
+        if (!lineEnd) lineEnd = end;
+        p = lineEnd + 1;
+
+        if (lineStart == lineEnd || *lineStart == '#' || *lineStart == ';') continue;
+
+        if (*lineStart == '[') {
+            /* Settings outside the leading, unnamed section belong to that section */
+            const char* close = memchr(lineStart, ']', (size_t)(lineEnd - lineStart));
+            TextSpan header = { lineStart + 1, close ? (size_t)(close - lineStart - 1) : 0 };
+            inGlobalSection = false;
+            profile = BeginSection(config, header);
+            continue;
+        }
+        if (!inGlobalSection && !profile) continue;
+
+        const char* equals = memchr(lineStart, '=', (size_t)(lineEnd - lineStart));
+        if (!equals) continue;
+
+        TextSpan key = { lineStart, (size_t)(equals - lineStart) };
+        while (key.length > 0 && IsBlank(key.data[key.length - 1])) key.length--;
+
+        /* Value runs to the end of the line or a comment after whitespace */
+        const char* valueStart = equals + 1;
+        while (valueStart < lineEnd && IsBlank(*valueStart)) valueStart++;
+        const char* valueEnd = valueStart;
+        while (valueEnd < lineEnd &&
+               !((*valueEnd == '#' || *valueEnd == ';') && valueEnd > valueStart && IsBlank(valueEnd[-1]))) {
+            valueEnd++;
+        }
+        TextSpan value = { valueStart, (size_t)(valueEnd - valueStart) };
+        while (value.length > 0 && IsBlank(value.data[value.length - 1])) value.length--;
+
+        if (profile) {
+            ApplyProfileValue(profile, LookupConfigKey(key), value);
+        } else {
+            ApplyConfigValue(config, LookupConfigKey(key), value);
+        }
+    }
+}
+
+/*
+ * Load a config file (key=value format), mapped rather than read
+ */
+bool LoadConfig(const char* filename, Config* config) {
+    /* Set defaults first so a missing file still leaves a usable config */
+    SetDefaultConfig(config);
+
+    MappedFile file;
+    if (!MapFileReadOnly(filename, &file)) {
+        printf("ERROR: Could not open config file: %s\n", filename);
+        return false;
+    }
+
+    ParseConfigText((const char*)file.data, file.size, config);
+
+    UnmapFile(&file);
+    return true;
+}
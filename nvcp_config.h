@@ -0,0 +1,86 @@
+/*
+ * NVCP Toggle - Configuration
+ */
+
+#ifndef NVCP_CONFIG_H
+#define NVCP_CONFIG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MAX_PROFILES 32
+#define PROFILE_NAME_SIZE 32
+
+/* Display color settings, the global custom ones or a [profile.NAME] section */
+typedef struct {
+    char name[PROFILE_NAME_SIZE];  /* Empty for the global custom settings */
+    int vibrance;
+    int hue;
+    double brightness;
+    double contrast;
+    double gamma;
+    int temperature;  /* As Config's */
+} Profile;
+
+/* Configuration */
+typedef struct {
+    bool toggleAllDisplays;
+    bool keyPressToExit;
+    int workers;          /* Threads for toggleAllDisplays, 0 = one per display */
+    bool syncDisplays;    /* One on/off decision for all displays */
+    bool gammaOnly;       /* Gamma ramp only: leave vibrance and hue alone, never load NVAPI */
+    int fadeDuration;     /* ms a toggle fades over, 0 = switch instantly */
+    char fadeEase[16];    /* Fade curve, see ParseFadeCurve */
+    int vibrance;
+    int hue;
+    double brightness;
+    double contrast;
+    double gamma;
+    int temperature;  /* -100 (cool/blue) to +100 (warm/yellow), or 1900-10000 K */
+    bool composeRamps;    /* Apply ramps on top of the one each display already had */
+    char rampEngine[16];  /* Gamma ramp kernel, see SetGammaRampKernel */
+    bool rampCache;       /* Keep built ramps in a memory-mapped cache file */
+    bool compiledConfig;  /* Load from / save a compiled copy of the config file */
+    bool stateJournal;    /* Trust the recorded last-applied state over reading displays back */
+    bool cycleProfiles;   /* Step through profiles instead of toggling */
+    int profileCount;
+    Profile profiles[MAX_PROFILES];  /* [profile.NAME] sections in file order */
+} Config;
+
+/* Default values (in percentage, 0-100 scale) */
+static const int DEFAULT_VIBRANCE_PCT = 50;  /* 50% = neutral/default in NVCP */
+static const int DEFAULT_HUE = 0;
+static const double DEFAULT_BRIGHTNESS = 0.5;
+static const double DEFAULT_CONTRAST = 0.5;
+static const double DEFAULT_GAMMA = 1.0;
+
+/*
+ * Fill in the built-in configuration used when no config file is available
+ */
+void SetDefaultConfig(Config* config);
+
+/*
+ * The global custom settings as an unnamed profile
+ */
+void GetCustomProfile(const Config* config, Profile* profile);
+
+/*
+ * Apply the key=value settings in config text on top of config.
+ * Lines may be any length; '#' and ';' start comments. Keys under a
+ * [profile.NAME] header set that profile, which starts out as a copy of
+ * the global custom settings; other sections are skipped.
+ */
+void ParseConfigText(const char* text, size_t length, Config* config);
+
+/*
+ * Name of a key in the parser's key table that sits in a slot other than the
+ * one its name hashes to, so it would never be recognized; NULL if none
+ */
+const char* FindMisplacedConfigKey(void);
+
+/*
+ * Load a config file (key=value format) over the built-in defaults
+ */
+bool LoadConfig(const char* filename, Config* config);
+
+#endif /* NVCP_CONFIG_H */
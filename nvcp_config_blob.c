@@ -0,0 +1,108 @@
+/*
+ * NVCP Toggle - Compiled config
+ *
+ * The blob is a single fixed-layout struct written with one fwrite and read
+ * with one fread. It is tied to the build by its size and to the config file
+ * by size, last-write time and content hash; a checksum over the whole blob
+ * catches torn writes.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nvcp_config_blob.h"
+#include "nvcp_hash.h"
+#include "nvcp_platform.h"
+
+#define CONFIG_BLOB_MAGIC   0x4243564Eu  /* "NVCB" */
+#define CONFIG_BLOB_VERSION 7  /* Also bumped when a default changes */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t blobSize;    /* sizeof(ConfigBlob), changes with Config's layout */
+    uint32_t reserved;
+    FileStamp iniStamp;
+    uint64_t iniHash;
+    CompiledConfig compiled;
+    uint64_t checksum;    /* Of everything above */
+} ConfigBlob;
+
+static uint64_t BlobChecksum(const ConfigBlob* blob) {
+    return HashWords(FNV1A64_OFFSET, blob, offsetof(ConfigBlob, checksum));
+}
+
+/*
+ * Content hash of the config file. Read in blocks: for a file this small
+ * mapping costs more than reading it.
+ */
+static bool HashConfigFile(const char* iniPath, uint64_t* hash) {
+    FILE* f = fopen(iniPath, "rb");
+    if (!f) return false;
+
+    uint64_t buffer[1024];
+    size_t read;
+    *hash = FNV1A64_OFFSET;
+    while ((read = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        size_t words = read & ~(size_t)7;
+        *hash = HashWords(*hash, buffer, words);
+        *hash = HashBytes(*hash, (const unsigned char*)buffer + words, read - words);
+    }
+
+    fclose(f);
+    return true;
+}
+
+/*
+ * Load the compiled config if it matches the config file
+ */
+bool LoadCompiledConfig(const char* blobPath, const char* iniPath, CompiledConfig* compiled) {
+    static ConfigBlob blob;  /* Large; keep it off the stack */
+
+    FILE* f = fopen(blobPath, "rb");
+    if (!f) return false;
+    size_t read = fread(&blob, 1, sizeof(blob), f);
+    fclose(f);
+
+    if (read != sizeof(blob) || blob.magic != CONFIG_BLOB_MAGIC || blob.version != CONFIG_BLOB_VERSION ||
+        blob.blobSize != sizeof(ConfigBlob) || blob.checksum != BlobChecksum(&blob)) {
+        return false;
+    }
+
+    /* Cheap stamp comparison first, then the content hash */
+    FileStamp stamp;
+    if (!GetFileStamp(iniPath, &stamp) || stamp.size != blob.iniStamp.size ||
+        stamp.modifiedTime != blob.iniStamp.modifiedTime) {
+        return false;
+    }
+    uint64_t hash;
+    if (!HashConfigFile(iniPath, &hash) || hash != blob.iniHash) {
+        return false;
+    }
+
+    *compiled = blob.compiled;
+    return true;
+}
+
+/*
+ * Write the compiled config for the current contents of the config file
+ */
+bool SaveCompiledConfig(const char* blobPath, const char* iniPath, const CompiledConfig* compiled) {
+    static ConfigBlob blob;
+
+    memset(&blob, 0, sizeof(blob));
+    blob.magic = CONFIG_BLOB_MAGIC;
+    blob.version = CONFIG_BLOB_VERSION;
+    blob.blobSize = sizeof(ConfigBlob);
+    if (!GetFileStamp(iniPath, &blob.iniStamp) || !HashConfigFile(iniPath, &blob.iniHash)) return false;
+    blob.compiled = *compiled;
+    blob.checksum = BlobChecksum(&blob);
+
+    FILE* f = fopen(blobPath, "wb");
+    if (!f) return false;
+    bool ok = fwrite(&blob, sizeof(blob), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) remove(blobPath);
+    return ok;
+}
@@ -0,0 +1,36 @@
+/*
+ * NVCP Toggle - Compiled config
+ * Binary snapshot of a parsed config file and its custom ramp, stored next
+ * to the executable so an unchanged config loads with one read and no parsing.
+ */
+
+#ifndef NVCP_CONFIG_BLOB_H
+#define NVCP_CONFIG_BLOB_H
+
+#include <stdbool.h>
+
+#include "nvcp_config.h"
+#include "nvcp_ramp.h"
+
+#define CONFIG_BLOB_FILE_NAME "native_nvcp_config.bin"
+
+/* Everything startup derives from the config file */
+typedef struct {
+    Config config;
+    char kernel[16];     /* Ramp kernel that built customRamp */
+    GammaRamp customRamp;
+} CompiledConfig;
+
+/*
+ * Load the compiled config if it was compiled from the config file as it is
+ * now (same size, last-write time and content hash). Returns false if the
+ * blob is missing, stale or damaged; the caller then parses the text.
+ */
+bool LoadCompiledConfig(const char* blobPath, const char* iniPath, CompiledConfig* compiled);
+
+/*
+ * Write the compiled config for the current contents of the config file
+ */
+bool SaveCompiledConfig(const char* blobPath, const char* iniPath, const CompiledConfig* compiled);
+
+#endif /* NVCP_CONFIG_BLOB_H */
@@ -0,0 +1,117 @@
+/*
+ * NVCP Toggle - Resident daemon mode
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "nvcp_daemon.h"
+#include "nvcp_ipc.h"
+#include "nvcp_latency.h"
+#include "nvcp_output.h"
+#include "nvcp_platform.h"
+
+#define ACCEPT_BACKOFF_MIN_MS 10
+#define ACCEPT_BACKOFF_MAX_MS 1000
+#define ACCEPT_MAX_FAILURES   50   /* In a row; about 45 s of backoff */
+
+/*
+ * Serve requests until a "stop" command
+ */
+int RunDaemon(const ToggleContext* ctx, const DisplaySet* displays) {
+    IpcServer server;
+    if (!IpcListen(&server)) {
+        printf("ERROR: Could not open the daemon channel (is a daemon already running?)\n");
+        return 1;
+    }
+
+    printf("Daemon ready: %d display(s), backend %s, ramp kernel %s\n",
+           displays->count, ctx->backend->name, GetGammaRampKernelName());
+    fflush(stdout);
+
+    bool running = true;
+    int acceptFailures = 0;
+    uint32_t backoffMs = ACCEPT_BACKOFF_MIN_MS;
+    Output out;
+    OutputInit(&out);
+
+    while (running) {
+        IpcChannel channel;
+        if (!IpcAccept(&server, &channel)) {
+            /* A transient failure clears up with a pause; a broken channel would otherwise spin forever */
+            if (++acceptFailures >= ACCEPT_MAX_FAILURES) {
+                printf("ERROR: The daemon channel failed %d times in a row; stopping\n", acceptFailures);
+                OutputFree(&out);
+                IpcServerClose(&server);
+                return 1;
+            }
+            SleepNs((uint64_t)backoffMs * 1000000);
+            if (backoffMs < ACCEPT_BACKOFF_MAX_MS) backoffMs *= 2;
+            continue;
+        }
+        acceptFailures = 0;
+        backoffMs = ACCEPT_BACKOFF_MIN_MS;
+
+        char command[IPC_MAX_COMMAND];
+        if (!IpcReceiveCommand(&channel, command)) {
+            IpcClose(&channel);
+            continue;
+        }
+
+        uint64_t start = GetMonotonicNs();
+        if (strcmp(command, "toggle") == 0) {
+            ToggleDisplays(ctx, displays, &out);
+        } else if (strcmp(command, "stats") == 0) {
+            if (latencyEnabled) {
+                PrintDriverLatency(&out);
+            } else {
+                OutputPrintf(&out, "Latency recording is off; start the daemon with --latency\n");
+            }
+        } else if (strcmp(command, "ping") == 0) {
+            OutputPrintf(&out, "pong\n");
+        } else if (strcmp(command, "stop") == 0) {
+            OutputPrintf(&out, "Daemon stopping\n");
+            running = false;
+        } else {
+            OutputPrintf(&out, "ERROR: Unknown command: %s\n", command);
+        }
+
+        IpcSend(&channel, out.data ? out.data : "", out.length);
+        IpcClose(&channel);
+        out.length = 0;
+
+        printf("Served %s in %.1f us\n", command, (double)(GetMonotonicNs() - start) / 1000.0);
+        fflush(stdout);
+    }
+
+    OutputFree(&out);
+    IpcServerClose(&server);
+    return 0;
+}
+
+/*
+ * Send a command to a running daemon and copy its reply to replyStream
+ */
+bool SendDaemonCommand(const char* command, FILE* replyStream) {
+    IpcChannel channel;
+    if (!IpcConnect(&channel)) {
+        return false;
+    }
+
+    char line[IPC_MAX_COMMAND + 1];
+    int length = snprintf(line, sizeof(line), "%s\n", command);
+    if (length <= 0 || !IpcSend(&channel, line, (size_t)length)) {
+        IpcClose(&channel);
+        return false;
+    }
+
+    char buffer[4096];
+    int n;
+    while ((n = IpcReceive(&channel, buffer, sizeof(buffer))) > 0) {
+        fwrite(buffer, 1, (size_t)n, replyStream);
+    }
+    fflush(replyStream);
+
+    IpcClose(&channel);
+    return true;
+}
@@ -0,0 +1,27 @@
+/*
+ * NVCP Toggle - Resident daemon mode
+ * Keeps the driver initialized, the undocumented entry points resolved and
+ * the display handles open, and serves toggle requests over local IPC.
+ */
+
+#ifndef NVCP_DAEMON_H
+#define NVCP_DAEMON_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "nvcp_toggle.h"
+
+/*
+ * Serve requests until a "stop" command. The backend must already be
+ * initialized and the display set open. Returns the process exit code.
+ */
+int RunDaemon(const ToggleContext* ctx, const DisplaySet* displays);
+
+/*
+ * Send a command ("toggle", "stats", "ping", "stop") to a running daemon and copy
+ * its reply to replyStream. Returns false if no daemon is listening.
+ */
+bool SendDaemonCommand(const char* command, FILE* replyStream);
+
+#endif /* NVCP_DAEMON_H */
@@ -0,0 +1,128 @@
+/*
+ * NVCP Toggle - Fade transitions
+ */
+
+#include <string.h>
+
+#include "nvcp_fade.h"
+#include "nvcp_lut.h"
+
+/*
+ * Curve for a name
+ */
+bool ParseFadeCurve(const char* name, FadeCurve* curve) {
+    static const struct {
+        const char* name;
+        FadeCurve curve;
+    } curves[] = {
+        { "linear", FADE_LINEAR },
+        { "smooth", FADE_SMOOTH },
+        { "ease-in", FADE_EASE_IN },
+        { "ease-out", FADE_EASE_OUT },
+    };
+
+    for (size_t i = 0; i < sizeof(curves) / sizeof(curves[0]); i++) {
+        if (strcmp(name, curves[i].name) == 0) {
+            *curve = curves[i].curve;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Eased progress for linear progress t in [0, 1]
+ */
+static double EaseProgress(FadeCurve curve, double t) {
+    switch (curve) {
+    case FADE_SMOOTH:
+        return t * t * (3.0 - 2.0 * t);
+    case FADE_EASE_IN:
+        return t * t;
+    case FADE_EASE_OUT:
+        return t * (2.0 - t);
+    case FADE_LINEAR:
+        break;
+    }
+    return t;
+}
+
+static int LerpInt(int a, int b, double progress) {
+    double value = a + (b - a) * progress;
+    return (int)(value < 0 ? value - 0.5 : value + 0.5);
+}
+
+/*
+ * Hue part of the way from a to b the short way round the color wheel
+ */
+static int LerpHue(int a, int b, double progress) {
+    int delta = ((b - a) % 360 + 540) % 360 - 180;
+    int hue = (a + LerpInt(0, delta, progress)) % 360;
+    return hue < 0 ? hue + 360 : hue;
+}
+
+/*
+ * Compute the frames of a fade
+ */
+void BuildFadePlan(FadePlan* plan, const FadeEndpoint* from, const FadeEndpoint* to, uint64_t durationNs,
+                   FadeCurve curve) {
+    uint64_t frameCount = (durationNs + FADE_FRAME_NS - 1) / FADE_FRAME_NS;
+    if (frameCount < 1) frameCount = 1;
+    if (frameCount > FADE_MAX_FRAMES) frameCount = FADE_MAX_FRAMES;
+
+    /* Values on the display as of the last frame kept; unknown until written */
+    bool vibranceKnown = from->hasVibrance;
+    int vibrance = from->vibranceRaw;
+    bool hueKnown = from->hasHue;
+    int hue = from->hue;
+    const GammaRamp* ramp = from->ramp;
+
+    plan->count = 0;
+    plan->skipped = 0;
+    for (uint64_t k = 1; k <= frameCount; k++) {
+        bool last = (k == frameCount);
+        double progress = EaseProgress(curve, (double)k / (double)frameCount);
+        FadeFrame* frame = &plan->frames[plan->count];
+        GammaRamp* frameRamp = &plan->ramps[plan->count];
+
+        /* Shown from the start of its refresh, so the first change is immediate */
+        frame->atNs = (k - 1) * durationNs / frameCount;
+
+        frame->setVibrance = false;
+        if (to->hasVibrance && (last || from->hasVibrance)) {
+            frame->vibranceRaw = last ? to->vibranceRaw : LerpInt(from->vibranceRaw, to->vibranceRaw, progress);
+            frame->setVibrance = !vibranceKnown || frame->vibranceRaw != vibrance;
+        }
+
+        frame->setHue = false;
+        if (to->hasHue && (last || from->hasHue)) {
+            frame->hue = last ? to->hue : LerpHue(from->hue, to->hue, progress);
+            frame->setHue = !hueKnown || frame->hue != hue;
+        }
+
+        frame->setRamp = false;
+        if (to->ramp && (last || from->ramp)) {
+            if (last) {
+                *frameRamp = *to->ramp;
+            } else {
+                BlendGammaRamps(frameRamp, from->ramp, to->ramp, progress);
+            }
+            frame->setRamp = !ramp || !GammaRampsMatch(frameRamp, ramp, 0);
+        }
+
+        if (!frame->setVibrance && !frame->setHue && !frame->setRamp) {
+            plan->skipped++;
+            continue;
+        }
+        if (frame->setVibrance) {
+            vibranceKnown = true;
+            vibrance = frame->vibranceRaw;
+        }
+        if (frame->setHue) {
+            hueKnown = true;
+            hue = frame->hue;
+        }
+        if (frame->setRamp) ramp = frameRamp;
+        plan->count++;
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * NVCP Toggle - Fade transitions
+ * Precomputed frames that move a display from its current vibrance, hue and
+ * gamma ramp to a target over time instead of in one write.
+ */
+
+#ifndef NVCP_FADE_H
+#define NVCP_FADE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nvcp_ramp.h"
+
+#define FADE_MAX_DISPLAYS 32
+#define FADE_MAX_FRAMES   48         /* 800 ms at 60 Hz; longer fades space frames wider */
+#define FADE_FRAME_NS     16666667ull  /* One 60 Hz refresh */
+#define FADE_MAX_MS       5000
+
+/* Easing applied to the fade's progress */
+typedef enum {
+    FADE_LINEAR,
+    FADE_SMOOTH,    /* Smoothstep: slow start and end */
+    FADE_EASE_IN,
+    FADE_EASE_OUT,
+} FadeCurve;
+
+/* One end of a fade. A field left unset is unknown at the start (so it jumps
+ * at the end) or is not to be written at the end. */
+typedef struct {
+    bool hasVibrance;
+    int vibranceRaw;
+    bool hasHue;
+    int hue;
+    const GammaRamp* ramp;  /* NULL = unknown / not written */
+} FadeEndpoint;
+
+/* Driver writes of one frame; the ramp is the plan's ramps entry of the same index */
+typedef struct {
+    uint64_t atNs;  /* Since the fade started */
+    bool setVibrance;
+    int vibranceRaw;
+    bool setHue;
+    int hue;
+    bool setRamp;
+} FadeFrame;
+
+/* A display's frames, computed up front so the timed loop only writes */
+typedef struct {
+    FadeFrame frames[FADE_MAX_FRAMES];
+    GammaRamp ramps[FADE_MAX_FRAMES];
+    int count;
+    int skipped;  /* Frames dropped because nothing changed after quantizing */
+} FadePlan;
+
+/* Fade settings and a plan per display index, reused by every toggle */
+typedef struct {
+    uint64_t durationNs;
+    FadeCurve curve;
+    FadePlan plans[FADE_MAX_DISPLAYS];
+} FadeArena;
+
+/*
+ * Curve for a name: "linear", "smooth", "ease-in" or "ease-out".
+ * Returns false for any other name.
+ */
+bool ParseFadeCurve(const char* name, FadeCurve* curve);
+
+/*
+ * Compute the frames of a fade from one endpoint to the other. The last frame
+ * writes the target exactly; frames identical to the one before are dropped.
+ */
+void BuildFadePlan(FadePlan* plan, const FadeEndpoint* from, const FadeEndpoint* to, uint64_t durationNs,
+                   FadeCurve curve);
+
+#endif /* NVCP_FADE_H */
@@ -0,0 +1,45 @@
+/*
+ * NVCP Toggle - Hashing helpers
+ * FNV-1a based, used for cache keys and file checksums
+ */
+
+#ifndef NVCP_HASH_H
+#define NVCP_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define FNV1A64_OFFSET 0xCBF29CE484222325ull
+#define FNV1A64_PRIME  0x00000100000001B3ull
+
+/*
+ * FNV-1a 64-bit over a byte range, continuing from hash
+ * (pass FNV1A64_OFFSET to start a new hash)
+ */
+static inline uint64_t HashBytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= FNV1A64_PRIME;
+    }
+    return hash;
+}
+
+/*
+ * FNV-1a style hash that consumes 8 bytes per step, for checksumming larger
+ * blocks (ramps, file payloads). size must be a multiple of 8.
+ */
+static inline uint64_t HashWords(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        hash ^= word;
+        hash *= FNV1A64_PRIME;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+#endif /* NVCP_HASH_H */
@@ -0,0 +1,282 @@
+/*
+ * NVCP Toggle - Local IPC channel
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_ipc.h"
+#include "nvcp_platform.h"
+
+#ifdef _WIN32
+
+/*
+ * Finish an overlapped operation on the server pipe that started with result
+ * started, waiting at most timeoutMs for it
+ */
+static bool CompleteOverlapped(HANDLE pipe, OVERLAPPED* overlapped, BOOL started, DWORD timeoutMs, DWORD* bytes) {
+    if (!started && GetLastError() != ERROR_IO_PENDING) return false;
+    if (!started && WaitForSingleObject(overlapped->hEvent, timeoutMs) != WAIT_OBJECT_0) {
+        /* The operation still refers to the caller's buffer: cancel and wait it out */
+        CancelIo(pipe);
+        GetOverlappedResult(pipe, overlapped, bytes, TRUE);
+        return false;
+    }
+    return GetOverlappedResult(pipe, overlapped, bytes, FALSE) != 0;
+}
+
+bool IpcListen(IpcServer* server) {
+    /* FILE_FLAG_FIRST_PIPE_INSTANCE makes a second daemon fail instead of sharing the name */
+    HANDLE pipe = CreateNamedPipeA(IPC_PIPE_NAME,
+                                   PIPE_ACCESS_DUPLEX | FILE_FLAG_FIRST_PIPE_INSTANCE | FILE_FLAG_OVERLAPPED,
+                                   PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                   1, 4096, 4096, 0, NULL);
+    if (pipe == INVALID_HANDLE_VALUE) return false;
+    HANDLE event = CreateEventA(NULL, TRUE, FALSE, NULL);
+    if (!event) {
+        CloseHandle(pipe);
+        return false;
+    }
+    server->pipe = pipe;
+    server->event = event;
+    return true;
+}
+
+bool IpcAccept(IpcServer* server, IpcChannel* channel) {
+    HANDLE pipe = (HANDLE)server->pipe;
+    OVERLAPPED overlapped = {0};
+    overlapped.hEvent = (HANDLE)server->event;
+    DWORD unused;
+    while (!ConnectNamedPipe(pipe, &overlapped)) {
+        DWORD error = GetLastError();
+        if (error == ERROR_NO_DATA) {
+            /* A client came and went before we got here: free the instance and wait again */
+            DisconnectNamedPipe(pipe);
+            continue;
+        }
+        if (error != ERROR_PIPE_CONNECTED && !CompleteOverlapped(pipe, &overlapped, FALSE, INFINITE, &unused)) {
+            return false;
+        }
+        break;
+    }
+    channel->handle = pipe;
+    channel->event = server->event;
+    channel->serverSide = true;
+    return true;
+}
+
+void IpcServerClose(IpcServer* server) {
+    if (server->pipe) CloseHandle((HANDLE)server->pipe);
+    if (server->event) CloseHandle((HANDLE)server->event);
+    server->pipe = NULL;
+    server->event = NULL;
+}
+
+bool IpcConnect(IpcChannel* channel) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        HANDLE pipe = CreateFileA(IPC_PIPE_NAME, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+        if (pipe != INVALID_HANDLE_VALUE) {
+            channel->handle = pipe;
+            channel->event = NULL;
+            channel->serverSide = false;
+            return true;
+        }
+        /* Daemon is busy with another client: wait briefly for the instance to free up */
+        if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(IPC_PIPE_NAME, 1000)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool IpcSend(IpcChannel* channel, const char* data, size_t size) {
+    HANDLE handle = (HANDLE)channel->handle;
+    while (size > 0) {
+        DWORD written = 0;
+        if (channel->event) {
+            OVERLAPPED overlapped = {0};
+            overlapped.hEvent = (HANDLE)channel->event;
+            BOOL started = WriteFile(handle, data, (DWORD)size, NULL, &overlapped);
+            if (!CompleteOverlapped(handle, &overlapped, started, IPC_CLIENT_TIMEOUT_MS, &written)) return false;
+        } else if (!WriteFile(handle, data, (DWORD)size, &written, NULL)) {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+int IpcReceive(IpcChannel* channel, char* buffer, size_t size) {
+    HANDLE handle = (HANDLE)channel->handle;
+    DWORD read = 0;
+    BOOL ok;
+    if (channel->event) {
+        OVERLAPPED overlapped = {0};
+        overlapped.hEvent = (HANDLE)channel->event;
+        BOOL started = ReadFile(handle, buffer, (DWORD)size, NULL, &overlapped);
+        ok = CompleteOverlapped(handle, &overlapped, started, IPC_CLIENT_TIMEOUT_MS, &read);
+    } else {
+        ok = ReadFile(handle, buffer, (DWORD)size, &read, NULL);
+    }
+    if (!ok) return GetLastError() == ERROR_BROKEN_PIPE ? 0 : -1;
+    return (int)read;
+}
+
+void IpcClose(IpcChannel* channel) {
+    HANDLE handle = (HANDLE)channel->handle;
+    if (channel->serverSide) {
+        /* Keep the pipe instance for the next client */
+        FlushFileBuffers(handle);
+        DisconnectNamedPipe(handle);
+    } else {
+        CloseHandle(handle);
+    }
+    channel->handle = NULL;
+}
+
+#else
+
+static void GetSocketPath(char* path, size_t size) {
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir && runtimeDir[0]) {
+        snprintf(path, size, "%s/%s", runtimeDir, IPC_SOCKET_NAME);
+    } else {
+        snprintf(path, size, "/tmp/%u-%s", (unsigned)getuid(), IPC_SOCKET_NAME);
+    }
+}
+
+static bool MakeAddress(struct sockaddr_un* addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    char path[sizeof(addr->sun_path) + 1];
+    GetSocketPath(path, sizeof(path));
+    if (strlen(path) >= sizeof(addr->sun_path)) return false;
+    memcpy(addr->sun_path, path, strlen(path) + 1);
+    return true;
+}
+
+bool IpcListen(IpcServer* server) {
+    struct sockaddr_un addr;
+    if (!MakeAddress(&addr)) return false;
+
+    /* Refuse to take over a socket that still has a live daemon behind it */
+    IpcChannel probe;
+    if (IpcConnect(&probe)) {
+        IpcClose(&probe);
+        return false;
+    }
+    unlink(addr.sun_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 8) != 0) {
+        close(fd);
+        return false;
+    }
+
+    server->fd = fd;
+    snprintf(server->path, sizeof(server->path), "%s", addr.sun_path);
+    return true;
+}
+
+bool IpcAccept(IpcServer* server, IpcChannel* channel) {
+    int fd;
+    do {
+        fd = accept(server->fd, NULL, NULL);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) return false;
+
+    struct timeval timeout = { IPC_CLIENT_TIMEOUT_MS / 1000, (IPC_CLIENT_TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    channel->fd = fd;
+    channel->serverSide = true;
+    return true;
+}
+
+void IpcServerClose(IpcServer* server) {
+    if (server->fd >= 0) {
+        close(server->fd);
+        unlink(server->path);
+    }
+    server->fd = -1;
+}
+
+bool IpcConnect(IpcChannel* channel) {
+    struct sockaddr_un addr;
+    if (!MakeAddress(&addr)) return false;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    channel->fd = fd;
+    channel->serverSide = false;
+    return true;
+}
+
+bool IpcSend(IpcChannel* channel, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = send(channel->fd, data, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+int IpcReceive(IpcChannel* channel, char* buffer, size_t size) {
+    ssize_t n;
+    do {
+        n = recv(channel->fd, buffer, size, 0);
+    } while (n < 0 && errno == EINTR);
+    return (int)n;
+}
+
+void IpcClose(IpcChannel* channel) {
+    close(channel->fd);
+    channel->fd = -1;
+}
+
+#endif
+
+/*
+ * Read one command line (without the newline) into command
+ */
+bool IpcReceiveCommand(IpcChannel* channel, char command[IPC_MAX_COMMAND]) {
+    /* The whole line, not each byte, must arrive in time, or a trickling client holds the daemon */
+    uint64_t deadline = GetMonotonicNs() + (uint64_t)IPC_CLIENT_TIMEOUT_MS * 1000000;
+    size_t length = 0;
+    while (length < IPC_MAX_COMMAND - 1) {
+        char c;
+        int n = IpcReceive(channel, &c, 1);
+        if (n < 0 || GetMonotonicNs() > deadline) return false;  /* Don't act on a partial command */
+        if (n == 0) break;
+        if (c == '\n') {
+            command[length] = '\0';
+            return true;
+        }
+        if (c != '\r') command[length++] = c;
+    }
+    command[length] = '\0';
+    return length > 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * NVCP Toggle - Local IPC channel between the resident daemon and clients
+ * Named pipe on Windows, Unix domain socket elsewhere. One request per
+ * connection: the client sends a single command line, the daemon replies
+ * with text and closes.
+ */
+
+#ifndef NVCP_IPC_H
+#define NVCP_IPC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define IPC_PIPE_NAME "\\\\.\\pipe\\native_nvcp_toggle"
+#define IPC_SOCKET_NAME "native_nvcp_toggle.sock"
+#define IPC_MAX_COMMAND 64
+#define IPC_CLIENT_TIMEOUT_MS 1000  /* Longest the daemon waits on a client's read or write */
+
+typedef struct {
+#ifdef _WIN32
+    void* handle;
+    void* event;     /* Completes overlapped I/O on the server side, NULL for clients */
+#else
+    int fd;
+#endif
+    bool serverSide;
+} IpcChannel;
+
+typedef struct {
+#ifdef _WIN32
+    void* pipe;
+    void* event;
+#else
+    int fd;
+    char path[108];  /* sockaddr_un.sun_path */
+#endif
+} IpcServer;
+
+/*
+ * Create the listening endpoint. Fails if another daemon already owns it.
+ */
+bool IpcListen(IpcServer* server);
+
+/*
+ * Wait for the next client. Reads and writes on the server side of the
+ * channel give up after IPC_CLIENT_TIMEOUT_MS, so a stalled client cannot
+ * hold the daemon.
+ */
+bool IpcAccept(IpcServer* server, IpcChannel* channel);
+
+void IpcServerClose(IpcServer* server);
+
+/*
+ * Connect to a running daemon; fails fast when none is listening
+ */
+bool IpcConnect(IpcChannel* channel);
+
+bool IpcSend(IpcChannel* channel, const char* data, size_t size);
+
+/*
+ * Read up to size bytes. Returns the byte count, 0 at end of stream, -1 on error.
+ */
+int IpcReceive(IpcChannel* channel, char* buffer, size_t size);
+
+/*
+ * Read one command line (without the newline) into command. Fails if the
+ * client errors out or stops sending before the newline (or end of stream).
+ */
+bool IpcReceiveCommand(IpcChannel* channel, char command[IPC_MAX_COMMAND]);
+
+/*
+ * Finish the exchange: the server side flushes and disconnects, clients close
+ */
+void IpcClose(IpcChannel* channel);
+
+#endif /* NVCP_IPC_H */
@@ -0,0 +1,80 @@
+/*
+ * NVCP Toggle - Display state journal
+ *
+ * A slot file with one JournalState per display index, keyed by the profile
+ * index hash and valid for the current boot only.
+ */
+
+#include <string.h>
+
+#include "nvcp_hash.h"
+#include "nvcp_journal.h"
+
+#define JOURNAL_MAGIC   0x4A53564Eu  /* "NVSJ" */
+#define JOURNAL_VERSION 2
+
+/* A JournalState as stored: fixed widths, no padding */
+struct JournalRecord {
+    int32_t profile;
+    int32_t vibranceRaw;
+    int32_t dvcMin;
+    int32_t dvcMax;
+    int32_t hue;
+    int32_t reserved;
+    uint64_t rampFingerprint;
+};
+
+/*
+ * Open (or create) the journal
+ */
+bool OpenStateJournal(const char* path, uint64_t profilesHash, StateJournal* journal) {
+    SlotFileFormat format = { JOURNAL_MAGIC, JOURNAL_VERSION, JOURNAL_MAX_DISPLAYS,
+                              sizeof(struct JournalRecord), profilesHash, true };
+    return OpenSlotFile(path, &format, &journal->slots);
+}
+
+/*
+ * Unmap the journal
+ */
+void CloseStateJournal(StateJournal* journal) {
+    CloseSlotFile(&journal->slots);
+}
+
+/*
+ * Last state recorded for the display at index
+ */
+bool ReadJournalEntry(const StateJournal* journal, int index, const char* name, JournalState* state) {
+    struct JournalRecord record;
+    if (!ReadSlot(&journal->slots, index, name, &record)) return false;
+
+    state->profile = record.profile;
+    state->vibranceRaw = record.vibranceRaw;
+    state->dvcMin = record.dvcMin;
+    state->dvcMax = record.dvcMax;
+    state->hue = record.hue;
+    state->rampFingerprint = record.rampFingerprint;
+    return true;
+}
+
+/*
+ * Record the state just applied to the display at index
+ */
+void WriteJournalEntry(StateJournal* journal, int index, const char* name, const JournalState* state) {
+    struct JournalRecord record = { state->profile, state->vibranceRaw, state->dvcMin, state->dvcMax,
+                                    state->hue, 0, state->rampFingerprint };
+    WriteSlot(&journal->slots, index, name, &record);
+}
+
+/*
+ * Drop the entry for the display at index
+ */
+void ForgetJournalEntry(StateJournal* journal, int index) {
+    ForgetSlot(&journal->slots, index);
+}
+
+/*
+ * Fingerprint of a ramp as the journal records it
+ */
+uint64_t JournalRampFingerprint(const GammaRamp* ramp) {
+    return HashWords(FNV1A64_OFFSET, ramp, sizeof(*ramp));
+}
@@ -0,0 +1,68 @@
+/*
+ * NVCP Toggle - Display state journal
+ * Memory-mapped record of the settings last applied to each display, so a
+ * toggle can decide from the journal instead of reading every display back.
+ */
+
+#ifndef NVCP_JOURNAL_H
+#define NVCP_JOURNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nvcp_backend.h"
+#include "nvcp_ramp.h"
+#include "nvcp_slot_file.h"
+
+#define JOURNAL_FILE_NAME    "native_nvcp_state.bin"
+#define JOURNAL_MAX_DISPLAYS 32
+
+/* What was last applied to a display */
+typedef struct {
+    int profile;         /* Profile index or PROFILE_DEFAULT */
+    int vibranceRaw;
+    int dvcMin;
+    int dvcMax;
+    int hue;
+    uint64_t rampFingerprint;
+} JournalState;
+
+typedef struct {
+    SlotFile slots;
+} StateJournal;
+
+/*
+ * Open (or create) the journal. It is reset when it was written for another
+ * set of profiles (profilesHash, see HashProfileIndex) or before the last
+ * boot, when the driver started from defaults again.
+ */
+bool OpenStateJournal(const char* path, uint64_t profilesHash, StateJournal* journal);
+
+/*
+ * Unmap the journal; entries are written through the mapping
+ */
+void CloseStateJournal(StateJournal* journal);
+
+/*
+ * Last state recorded for the display at index, if it was recorded for a
+ * display of that name and the entry is whole (not torn by a crash or a
+ * concurrent writer)
+ */
+bool ReadJournalEntry(const StateJournal* journal, int index, const char* name, JournalState* state);
+
+/*
+ * Record the state just applied to the display at index
+ */
+void WriteJournalEntry(StateJournal* journal, int index, const char* name, const JournalState* state);
+
+/*
+ * Drop the entry for the display at index, so its next toggle reads it back
+ */
+void ForgetJournalEntry(StateJournal* journal, int index);
+
+/*
+ * Fingerprint of a ramp as the journal records it
+ */
+uint64_t JournalRampFingerprint(const GammaRamp* ramp);
+
+#endif /* NVCP_JOURNAL_H */
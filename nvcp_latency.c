@@ -0,0 +1,125 @@
+/*
+ * NVCP Toggle - Driver call latency
+ *
+ * Each histogram has four buckets per power of two of the latency in ns
+ * (values below 4 ns get a bucket each), so a bucket spans at most 25% of
+ * its lower bound. Buckets, call count and max are updated with atomic adds,
+ * so worker threads and the daemon record without locking.
+ */
+
+#include "nvcp_atomic.h"
+#include "nvcp_latency.h"
+
+#define LATENCY_BUCKETS 256
+
+typedef struct {
+    volatile uint64_t calls;
+    volatile uint64_t maxNs;
+    volatile uint64_t buckets[LATENCY_BUCKETS];
+} LatencyHistogram;
+
+static const char* const driverCallNames[DRIVER_CALL_COUNT] = {
+    [CALL_INITIALIZE]          = "Initialize",
+    [CALL_LOAD_EXTENSIONS]     = "LoadExtensions",
+    [CALL_OPEN_DISPLAY]        = "OpenDisplay",
+    [CALL_ENUM_DISPLAY_HANDLE] = "EnumNvidiaDisplayHandle",
+    [CALL_GET_DISPLAY_NAME]    = "GetAssociatedNvidiaDisplayName",
+    [CALL_CREATE_DC]           = "CreateDCA",
+    [CALL_CLOSE_DISPLAY]       = "CloseDisplay",
+    [CALL_GET_DVC_INFO]        = "GetDVCInfo",
+    [CALL_SET_DVC_LEVEL]       = "SetDVCLevel",
+    [CALL_GET_HUE_INFO]        = "GetHUEInfo",
+    [CALL_SET_HUE_ANGLE]       = "SetHUEAngle",
+    [CALL_GET_GAMMA_RAMP]      = "GetDeviceGammaRamp",
+    [CALL_SET_GAMMA_RAMP]      = "SetDeviceGammaRamp",
+    [CALL_UNLOAD]              = "Unload",
+};
+
+bool latencyEnabled = false;
+static LatencyHistogram histograms[DRIVER_CALL_COUNT];
+
+static int HighestBit(uint64_t value) {
+#ifdef _MSC_VER
+    /* _BitScanReverse64 is x64/ARM64 only; scan the dwords so x86 builds too */
+    unsigned long index;
+    if (_BitScanReverse(&index, (unsigned long)(value >> 32))) return (int)index + 32;
+    _BitScanReverse(&index, (unsigned long)value);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+static int BucketIndex(uint64_t ns) {
+    if (ns < 4) return (int)ns;
+    int exponent = HighestBit(ns);
+    int sub = (int)(ns >> (exponent - 2)) & 3;
+    return ((exponent - 1) << 2) + sub;
+}
+
+/* Middle of a bucket's range */
+static uint64_t BucketMidpoint(int index) {
+    if (index < 4) return (uint64_t)index;
+    int exponent = (index >> 2) + 1;
+    uint64_t width = 1ull << (exponent - 2);
+    uint64_t lower = (uint64_t)(4 + (index & 3)) << (exponent - 2);
+    return lower + width / 2;
+}
+
+/*
+ * Start recording driver call latencies
+ */
+void EnableDriverLatency(void) {
+    latencyEnabled = true;
+}
+
+/*
+ * Add one call that started at startNs
+ */
+void RecordDriverCall(DriverCall call, uint64_t startNs) {
+    uint64_t elapsed = GetMonotonicNs() - startNs;
+    LatencyHistogram* histogram = &histograms[call];
+    AtomicAdd64(&histogram->buckets[BucketIndex(elapsed)], 1);
+    AtomicAdd64(&histogram->calls, 1);
+    AtomicMax64(&histogram->maxNs, elapsed);
+}
+
+/*
+ * Latency at quantile q of a call
+ */
+uint64_t GetDriverCallQuantile(DriverCall call, double q) {
+    const LatencyHistogram* histogram = &histograms[call];
+    uint64_t calls = AtomicLoad64(&histogram->calls);
+    if (calls == 0) return 0;
+
+    uint64_t rank = (uint64_t)(q * (double)calls + 0.999999);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    uint64_t maxNs = AtomicLoad64(&histogram->maxNs);
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += AtomicLoad64(&histogram->buckets[i]);
+        if (seen >= rank) {
+            uint64_t mid = BucketMidpoint(i);
+            return mid < maxNs ? mid : maxNs;
+        }
+    }
+    return maxNs;
+}
+
+/*
+ * Print calls, p50, p90, p99 and max for every call made so far
+ */
+void PrintDriverLatency(Output* out) {
+    OutputPrintf(out, "\n%-32s %8s %10s %10s %10s %10s\n", "Driver call", "Calls", "p50 us", "p90 us", "p99 us",
+                 "max us");
+    for (int i = 0; i < DRIVER_CALL_COUNT; i++) {
+        uint64_t calls = AtomicLoad64(&histograms[i].calls);
+        if (!calls) continue;
+        OutputPrintf(out, "%-32s %8llu %10.1f %10.1f %10.1f %10.1f\n", driverCallNames[i],
+                     (unsigned long long)calls,
+                     (double)GetDriverCallQuantile((DriverCall)i, 0.50) / 1e3,
+                     (double)GetDriverCallQuantile((DriverCall)i, 0.90) / 1e3,
+                     (double)GetDriverCallQuantile((DriverCall)i, 0.99) / 1e3,
+                     (double)AtomicLoad64(&histograms[i].maxNs) / 1e3);
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * NVCP Toggle - Driver call latency
+ * Lock-free log-bucketed histograms of every driver and GDI call, to see
+ * which calls regress between driver versions.
+ */
+
+#ifndef NVCP_LATENCY_H
+#define NVCP_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nvcp_output.h"
+#include "nvcp_platform.h"
+
+typedef enum {
+    CALL_INITIALIZE,
+    CALL_LOAD_EXTENSIONS,
+    CALL_OPEN_DISPLAY,
+    CALL_ENUM_DISPLAY_HANDLE,
+    CALL_GET_DISPLAY_NAME,
+    CALL_CREATE_DC,
+    CALL_CLOSE_DISPLAY,
+    CALL_GET_DVC_INFO,
+    CALL_SET_DVC_LEVEL,
+    CALL_GET_HUE_INFO,
+    CALL_SET_HUE_ANGLE,
+    CALL_GET_GAMMA_RAMP,
+    CALL_SET_GAMMA_RAMP,
+    CALL_UNLOAD,
+    DRIVER_CALL_COUNT
+} DriverCall;
+
+extern bool latencyEnabled;
+
+/*
+ * Start recording driver call latencies
+ */
+void EnableDriverLatency(void);
+
+/*
+ * Add one call that started at startNs (thread-safe, lock-free)
+ */
+void RecordDriverCall(DriverCall call, uint64_t startNs);
+
+/*
+ * Latency at quantile q (0-1) of a call, in ns; bucket midpoints, so within 12.5%
+ */
+uint64_t GetDriverCallQuantile(DriverCall call, double q);
+
+/*
+ * Print calls, p50, p90, p99 and max for every call made so far
+ */
+void PrintDriverLatency(Output* out);
+
+/* Time a driver call made inside a backend */
+#define DRIVER_CALL_BEGIN(var) uint64_t var = latencyEnabled ? GetMonotonicNs() : 0
+#define DRIVER_CALL_END(call, var) \
+    do { if (var) RecordDriverCall(call, var); } while (0)
+
+#endif /* NVCP_LATENCY_H */
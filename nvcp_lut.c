@@ -0,0 +1,117 @@
+/*
+ * NVCP Toggle - Ramp algebra
+ * Ramp entries map inputs i / 255 to outputs v / 65535, and 65535 = 255 * 257,
+ * so an output value v sits at input position v / 257 exactly: whole entry
+ * v / 257, fraction (v % 257) / 257. Composition and inversion interpolate on
+ * that grid in integer math. Blend and scale are plain element-wise loops
+ * over all 768 entries, written so compilers vectorize them.
+ */
+
+#include "nvcp_lut.h"
+
+#define LUT_STEP 257u           /* Output units per input entry */
+#define LUT_WEIGHT_ONE 32768u   /* Q15: keeps a * weight within 32 bits */
+
+/*
+ * out = outer(inner(x)) per channel
+ */
+void ComposeGammaRamps(GammaRamp* out, const GammaRamp* outer, const GammaRamp* inner) {
+    GammaRamp result;  /* out may alias either input */
+
+    for (int c = 0; c < 3; c++) {
+        const uint16_t* o = outer->ch[c];
+        for (int i = 0; i < GAMMA_RAMP_SIZE; i++) {
+            uint32_t v = inner->ch[c][i];
+            uint32_t index = v / LUT_STEP;
+            uint32_t frac = v % LUT_STEP;
+            if (index >= GAMMA_RAMP_SIZE - 1) {
+                result.ch[c][i] = o[GAMMA_RAMP_SIZE - 1];
+                continue;
+            }
+            result.ch[c][i] = (uint16_t)((o[index] * (LUT_STEP - frac) + o[index + 1] * frac + LUT_STEP / 2) /
+                                         LUT_STEP);
+        }
+    }
+    *out = result;
+}
+
+/*
+ * Inverse of one non-decreasing channel; a forward scan, since both the
+ * target values and the segment holding them only increase
+ */
+static void InvertChannel(uint16_t* out, const uint16_t* f) {
+    int i = 0;
+    for (int j = 0; j < GAMMA_RAMP_SIZE; j++) {
+        uint32_t y = (uint32_t)j * LUT_STEP;
+        if (y <= f[0]) {
+            out[j] = 0;
+            continue;
+        }
+        if (y > f[GAMMA_RAMP_SIZE - 1]) {
+            out[j] = UINT16_MAX;
+            continue;
+        }
+
+        /* First segment with f[i] < y <= f[i + 1] */
+        while (f[i + 1] < y) i++;
+        uint32_t rise = (uint32_t)f[i + 1] - f[i];
+        out[j] = (uint16_t)((uint32_t)i * LUT_STEP + ((y - f[i]) * LUT_STEP + rise / 2) / rise);
+    }
+}
+
+/*
+ * Inverse of a non-decreasing ramp per channel
+ */
+bool InvertGammaRamp(GammaRamp* out, const GammaRamp* ramp) {
+    for (int c = 0; c < 3; c++) {
+        for (int i = 1; i < GAMMA_RAMP_SIZE; i++) {
+            if (ramp->ch[c][i] < ramp->ch[c][i - 1]) return false;
+        }
+    }
+
+    GammaRamp result;  /* out may alias ramp */
+    for (int c = 0; c < 3; c++) {
+        InvertChannel(result.ch[c], ramp->ch[c]);
+    }
+    *out = result;
+    return true;
+}
+
+/*
+ * out = a * (1 - weight) + b * weight; unsigned so the loop vectorizes
+ * without sign fixups
+ */
+void BlendGammaRamps(GammaRamp* out, const GammaRamp* a, const GammaRamp* b, double weight) {
+    if (weight < 0.0) weight = 0.0;
+    if (weight > 1.0) weight = 1.0;
+
+    const uint16_t* pa = &a->ch[0][0];
+    const uint16_t* pb = &b->ch[0][0];
+    uint16_t* po = &out->ch[0][0];
+    uint32_t w = (uint32_t)(weight * LUT_WEIGHT_ONE + 0.5);
+    uint32_t inverse = LUT_WEIGHT_ONE - w;
+
+    for (int i = 0; i < 3 * GAMMA_RAMP_SIZE; i++) {
+        po[i] = (uint16_t)((pa[i] * inverse + pb[i] * w + LUT_WEIGHT_ONE / 2) >> 15);
+    }
+}
+
+/*
+ * out = in * scale[c] + offset[c] per channel, in single precision so the
+ * loop vectorizes
+ */
+void ScaleGammaRamp(GammaRamp* out, const GammaRamp* in, const double scale[3], const double offset[3]) {
+    for (int c = 0; c < 3; c++) {
+        const float s = (float)scale[c];
+        const float o = (float)(offset[c] * 65535.0) + 0.5f;  /* Rounding folded into the offset */
+        const uint16_t* src = in->ch[c];
+        uint16_t* dst = out->ch[c];
+
+        for (int i = 0; i < GAMMA_RAMP_SIZE; i++) {
+            float v = (float)src[i] * s + o;
+            if (v < 0.0f) v = 0.0f;
+            if (v > 65535.0f) v = 65535.0f;
+            dst[i] = (uint16_t)(int32_t)v;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * NVCP Toggle - Ramp algebra
+ * Operations that combine gamma ramps as 1D lookup tables, so a calibration
+ * ramp and a profile ramp can be joined at apply time instead of rebuilt.
+ * All run in one pass over the entries with integer or plain float math.
+ */
+
+#ifndef NVCP_LUT_H
+#define NVCP_LUT_H
+
+#include <stdbool.h>
+
+#include "nvcp_ramp.h"
+
+/*
+ * out = outer(inner(x)) per channel: each inner entry is looked up in outer,
+ * interpolating linearly between the two nearest outer entries. out may be
+ * either input.
+ */
+void ComposeGammaRamps(GammaRamp* out, const GammaRamp* outer, const GammaRamp* inner);
+
+/*
+ * Inverse of a non-decreasing ramp per channel, so that composing the two
+ * gives about the identity (steep sections lose a few LSB to interpolation,
+ * like any 256-entry table). Output values the ramp never reaches
+ * map to its first or last entry; flat runs map to their start. Returns
+ * false, leaving out unchanged, if some channel decreases anywhere.
+ */
+bool InvertGammaRamp(GammaRamp* out, const GammaRamp* ramp);
+
+/*
+ * out = a * (1 - weight) + b * weight, weight clamped to [0, 1]; rounded,
+ * so weight 0 and 1 give a and b exactly. out may be either input.
+ */
+void BlendGammaRamps(GammaRamp* out, const GammaRamp* a, const GammaRamp* b, double weight);
+
+/*
+ * out = in * scale[c] + offset[c] per channel c, with offset in full-scale
+ * units (1.0 = 65535), clamped to the ramp range. out may be in.
+ */
+void ScaleGammaRamp(GammaRamp* out, const GammaRamp* in, const double scale[3], const double offset[3]);
+
+#endif /* NVCP_LUT_H */
@@ -0,0 +1,73 @@
+/*
+ * NVCP Toggle - Output buffer
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_output.h"
+
+void OutputInit(Output* out) {
+    out->data = NULL;
+    out->length = 0;
+    out->capacity = 0;
+}
+
+void OutputFree(Output* out) {
+    free(out->data);
+    OutputInit(out);
+}
+
+static bool OutputReserve(Output* out, size_t extra) {
+    size_t needed = out->length + extra + 1;
+    if (needed <= out->capacity) return true;
+
+    size_t capacity = out->capacity ? out->capacity : 256;
+    while (capacity < needed) capacity *= 2;
+
+    char* data = (char*)realloc(out->data, capacity);
+    if (!data) return false;
+    out->data = data;
+    out->capacity = capacity;
+    return true;
+}
+
+/*
+ * Append formatted text
+ */
+void OutputPrintf(Output* out, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int needed = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+
+    if (needed > 0 && OutputReserve(out, (size_t)needed)) {
+        vsnprintf(out->data + out->length, out->capacity - out->length, format, args);
+        out->length += (size_t)needed;
+    }
+    va_end(args);
+}
+
+/*
+ * Append the contents of another buffer
+ */
+void OutputAppend(Output* out, const Output* other) {
+    if (other->length == 0 || !OutputReserve(out, other->length)) return;
+    memcpy(out->data + out->length, other->data, other->length);
+    out->length += other->length;
+    out->data[out->length] = '\0';
+}
+
+/*
+ * Write the buffered text to a stream and empty the buffer
+ */
+void OutputFlush(Output* out, FILE* stream) {
+    if (out->length) {
+        fwrite(out->data, 1, out->length, stream);
+        fflush(stream);
+    }
+    out->length = 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * NVCP Toggle - Output buffer
+ * Collects the text of a toggle run so it can go to the console, back to a
+ * daemon client, or be printed per display in a fixed order.
+ */
+
+#ifndef NVCP_OUTPUT_H
+#define NVCP_OUTPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} Output;
+
+void OutputInit(Output* out);
+void OutputFree(Output* out);
+
+/*
+ * Append formatted text
+ */
+void OutputPrintf(Output* out, const char* format, ...);
+
+/*
+ * Append the contents of another buffer
+ */
+void OutputAppend(Output* out, const Output* other);
+
+/*
+ * Write the buffered text to a stream and empty the buffer
+ */
+void OutputFlush(Output* out, FILE* stream);
+
+#endif /* NVCP_OUTPUT_H */
@@ -0,0 +1,283 @@
+/*
+ * NVCP Toggle - Platform helpers
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+
+#include "nvcp_platform.h"
+
+/*
+ * Build the path of a file that lives next to the executable
+ */
+void GetPathNextToExe(const char* fileName, char* out, size_t outSize) {
+    char exePath[NVCP_MAX_PATH];
+    size_t len = 0;
+
+#ifdef _WIN32
+    len = GetModuleFileNameA(NULL, exePath, (DWORD)sizeof(exePath));
+    if (len >= sizeof(exePath)) len = 0;
+#else
+    ssize_t n = readlink("/proc/self/exe", exePath, sizeof(exePath) - 1);
+    if (n > 0) len = (size_t)n;
+#endif
+    exePath[len] = '\0';
+
+    char* lastSlash = strrchr(exePath, PATH_SEPARATOR);
+    if (lastSlash) {
+        *lastSlash = '\0';
+        snprintf(out, outSize, "%s%c%s", exePath, PATH_SEPARATOR, fileName);
+    } else {
+        snprintf(out, outSize, "%s", fileName);
+    }
+}
+
+/*
+ * Map a file read/write, creating it and growing it to size bytes if needed
+ */
+bool MapFileWritable(const char* path, size_t size, MappedFile* mapped) {
+    memset(mapped, 0, sizeof(*mapped));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    /* CreateFileMapping grows the file to the mapping size */
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                                        (DWORD)((unsigned long long)size >> 32), (DWORD)size, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mapped->fileHandle = file;
+    mapped->mappingHandle = mapping;
+#else
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || ((size_t)st.st_size < size && ftruncate(fd, (off_t)size) != 0)) {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    mapped->fd = fd;
+#endif
+
+    mapped->data = data;
+    mapped->size = size;
+    return true;
+}
+
+/*
+ * Map an existing file read-only at its current size
+ */
+bool MapFileReadOnly(const char* path, MappedFile* mapped) {
+    memset(mapped, 0, sizeof(*mapped));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+    if (fileSize.QuadPart == 0) {
+        /* Zero-length files can't be mapped */
+        CloseHandle(file);
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mapped->fileHandle = file;
+    mapped->mappingHandle = mapping;
+    mapped->size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        /* Zero-length files can't be mapped */
+        close(fd);
+        return true;
+    }
+
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    mapped->fd = fd;
+    mapped->size = (size_t)st.st_size;
+#endif
+
+    mapped->data = data;
+    return true;
+}
+
+/*
+ * Unmap a file mapped with MapFileWritable or MapFileReadOnly
+ */
+void UnmapFile(MappedFile* mapped) {
+    if (!mapped->data) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapped->data);
+    CloseHandle((HANDLE)mapped->mappingHandle);
+    CloseHandle((HANDLE)mapped->fileHandle);
+#else
+    munmap(mapped->data, mapped->size);
+    close(mapped->fd);
+#endif
+
+    mapped->data = NULL;
+}
+
+/*
+ * Get a file's size and last-write time without opening it
+ */
+bool GetFileStamp(const char* path, FileStamp* stamp) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &info)) return false;
+    stamp->size = ((uint64_t)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+    stamp->modifiedTime = (int64_t)(((uint64_t)info.ftLastWriteTime.dwHighDateTime << 32) |
+                                    info.ftLastWriteTime.dwLowDateTime);
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    stamp->size = (uint64_t)st.st_size;
+    stamp->modifiedTime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+/*
+ * Monotonic high-resolution clock in nanoseconds
+ */
+uint64_t GetMonotonicNs(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (!frequency.QuadPart) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    /* Split to avoid overflowing counter * 1e9 */
+    uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+    uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+    return seconds * 1000000000ull + remainder * 1000000000ull / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+int64_t GetBootTime(void) {
+#ifdef _WIN32
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    uint64_t ticks = ((uint64_t)now.dwHighDateTime << 32) | now.dwLowDateTime;  /* 100 ns since 1601 */
+    int64_t seconds = (int64_t)(ticks / 10000000ull) - 11644473600ll;
+    return seconds - (int64_t)(GetTickCount64() / 1000);
+#else
+    struct timespec wall, uptime;
+    clock_gettime(CLOCK_REALTIME, &wall);
+#ifdef CLOCK_BOOTTIME
+    clock_gettime(CLOCK_BOOTTIME, &uptime);  /* Counts suspended time too */
+#else
+    clock_gettime(CLOCK_MONOTONIC, &uptime);
+#endif
+    return (int64_t)wall.tv_sec - (int64_t)uptime.tv_sec;
+#endif
+}
+
+void SleepNs(uint64_t ns) {
+#ifdef _WIN32
+    Sleep((DWORD)((ns + 999999) / 1000000));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000ull);
+    ts.tv_nsec = (long)(ns % 1000000000ull);
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+        /* Interrupted by a signal; sleep the rest */
+    }
+#endif
+}
+
+#if defined(_WIN32) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+void SleepUntilNs(uint64_t deadlineNs) {
+#ifdef _WIN32
+    uint64_t now = GetMonotonicNs();
+    if (now >= deadlineNs) return;
+
+    /* Without the high-resolution flag a timer wakes on the 1-15.6 ms system tick */
+    HANDLE timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!timer) timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+    if (timer) {
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)((deadlineNs - now) / 100);  /* Relative, in 100 ns units */
+        if (SetWaitableTimer(timer, &due, 0, NULL, NULL, FALSE)) WaitForSingleObject(timer, INFINITE);
+        CloseHandle(timer);
+    }
+    while (GetMonotonicNs() < deadlineNs) {
+        SwitchToThread();
+    }
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadlineNs / 1000000000ull);
+    ts.tv_nsec = (long)(deadlineNs % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        /* Interrupted by a signal; the deadline is absolute, so just wait again */
+    }
+#endif
+}
@@ -0,0 +1,92 @@
+/*
+ * NVCP Toggle - Platform helpers
+ * Thin wrappers over the few OS services the core needs
+ */
+
+#ifndef NVCP_PLATFORM_H
+#define NVCP_PLATFORM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define NVCP_MAX_PATH 1024
+
+#ifdef _WIN32
+#define PATH_SEPARATOR '\\'
+#else
+#define PATH_SEPARATOR '/'
+#endif
+
+/*
+ * Build the path of a file that lives next to the executable.
+ * Falls back to the bare file name (current directory) if the
+ * executable location can't be determined.
+ */
+void GetPathNextToExe(const char* fileName, char* out, size_t outSize);
+
+/* A file mapped into memory */
+typedef struct {
+    void* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+} MappedFile;
+
+/*
+ * Map a file read/write, creating it and growing it to size bytes if needed.
+ * New bytes read as zero.
+ */
+bool MapFileWritable(const char* path, size_t size, MappedFile* mapped);
+
+/*
+ * Map an existing file read-only at its current size. An empty file maps
+ * successfully with data NULL and size 0.
+ */
+bool MapFileReadOnly(const char* path, MappedFile* mapped);
+
+/*
+ * Unmap a file mapped with MapFileWritable or MapFileReadOnly
+ */
+void UnmapFile(MappedFile* mapped);
+
+/* Size and last-write time of a file */
+typedef struct {
+    uint64_t size;
+    int64_t modifiedTime;  /* Platform ticks; only compared for equality */
+} FileStamp;
+
+/*
+ * Get a file's size and last-write time without opening it
+ */
+bool GetFileStamp(const char* path, FileStamp* stamp);
+
+/*
+ * Monotonic high-resolution clock in nanoseconds
+ */
+uint64_t GetMonotonicNs(void);
+
+/*
+ * When the system last booted, in seconds since the Unix epoch. Derived from
+ * two clocks, so successive calls may differ by a second.
+ */
+int64_t GetBootTime(void);
+
+/*
+ * Block the calling thread for at least ns nanoseconds (the scheduler may
+ * add some; Windows sleeps in whole milliseconds)
+ */
+void SleepNs(uint64_t ns);
+
+/*
+ * Block the calling thread until GetMonotonicNs() reaches deadlineNs, to
+ * well under a millisecond where the OS allows (a high-resolution waitable
+ * timer on Windows 10 1803 and later)
+ */
+void SleepUntilNs(uint64_t deadlineNs);
+
+#endif /* NVCP_PLATFORM_H */
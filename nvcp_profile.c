@@ -0,0 +1,198 @@
+/*
+ * NVCP Toggle - Profile index
+ *
+ * Looking a display up is one probe of the ramp table, however many profiles
+ * there are and whether or not the driver rounds the ramp on readback: the
+ * key is taken from three ramp entries, and each profile is filed under
+ * every cell combination its readback can land in. Candidates are confirmed
+ * by comparing the settings and the full ramp within DEFAULT_RAMP_TOLERANCE,
+ * so keys shared by similar profiles can't match the wrong one.
+ *
+ * The fingerprint table hashes a profile's hue and exact ramp, for finding a
+ * profile recorded by fingerprint after the config renumbered it.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_hash.h"
+#include "nvcp_profile.h"
+#include "nvcp_toggle.h"
+
+_Static_assert((1 << PROFILE_CELL_SHIFT) > 2 * DEFAULT_RAMP_TOLERANCE,
+               "a value read back must land in the written value's cell or a neighbour");
+_Static_assert(PROFILE_RAMP_SLOTS >= 2 * PROFILE_RAMP_KEYS * MAX_PROFILES, "ramp table more than half full");
+
+static uint64_t Fingerprint(int hue, const GammaRamp* ramp) {
+    int32_t hueValue = hue;
+    uint64_t hash = HashBytes(FNV1A64_OFFSET, &hueValue, sizeof(hueValue));
+    return HashWords(hash, ramp, sizeof(*ramp));
+}
+
+/* Ramp table key of one cell per channel */
+static uint64_t RampKey(const int cells[3]) {
+    uint32_t packed = (uint32_t)cells[0] | (uint32_t)cells[1] << 8 | (uint32_t)cells[2] << 16;
+    return HashBytes(FNV1A64_OFFSET, &packed, sizeof(packed));
+}
+
+/*
+ * Whether profile i has the given hue and vibrance (raw DVC, within 1)
+ */
+static bool MatchesColorSettings(const ProfileIndex* index, int i, int vibranceRaw, int dvcMax, int hue) {
+    const Profile* profile = &index->profiles[i];
+    return profile->hue == hue && abs(PercentToDVC(profile->vibrance, dvcMax) - vibranceRaw) <= 1;
+}
+
+static void InsertSlot(ProfileSlot* slots, uint32_t mask, uint64_t fingerprint, int profile) {
+    /* Linear probing; each table is never more than half full */
+    uint32_t slot = (uint32_t)fingerprint & mask;
+    while (slots[slot].profile != 0) {
+        slot = (slot + 1) & mask;
+    }
+    slots[slot].fingerprint = fingerprint;
+    slots[slot].profile = profile + 1;
+}
+
+/*
+ * Empty the index
+ */
+void InitProfileIndex(ProfileIndex* index) {
+    index->count = 0;
+    memset(index->slots, 0, sizeof(index->slots));
+    memset(index->rampSlots, 0, sizeof(index->rampSlots));
+}
+
+/*
+ * Add a profile and the ramp built for it
+ */
+bool AddProfile(ProfileIndex* index, const Profile* profile, const GammaRamp* ramp) {
+    if (index->count >= MAX_PROFILES) return false;
+
+    int i = index->count++;
+    index->profiles[i] = *profile;
+    index->ramps[i] = *ramp;
+    InsertSlot(index->slots, PROFILE_INDEX_SLOTS - 1, Fingerprint(profile->hue, ramp), i);
+
+    /* Every cell each sampled entry can be read back in: one, or two when near a cell edge */
+    int lowCell[3], highCell[3];
+    for (int c = 0; c < 3; c++) {
+        int value = ramp->ch[c][PROFILE_SAMPLE_ENTRY];
+        lowCell[c] = (value > DEFAULT_RAMP_TOLERANCE ? value - DEFAULT_RAMP_TOLERANCE : 0) >> PROFILE_CELL_SHIFT;
+        highCell[c] = (value < 65535 - DEFAULT_RAMP_TOLERANCE ? value + DEFAULT_RAMP_TOLERANCE : 65535) >>
+                      PROFILE_CELL_SHIFT;
+    }
+    int cells[3];
+    for (cells[0] = lowCell[0]; cells[0] <= highCell[0]; cells[0]++) {
+        for (cells[1] = lowCell[1]; cells[1] <= highCell[1]; cells[1]++) {
+            for (cells[2] = lowCell[2]; cells[2] <= highCell[2]; cells[2]++) {
+                InsertSlot(index->rampSlots, PROFILE_RAMP_SLOTS - 1, RampKey(cells), i);
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Probe the ramp table for the profile whose ramp is the given one, an exact
+ * match before one within rounding, and the first in file order among
+ * those; with matchColor, vibrance and hue must match too
+ */
+static int ProbeRampTable(const ProfileIndex* index, const GammaRamp* ramp, bool matchColor, int vibranceRaw,
+                          int dvcMax, int hue) {
+    int cells[3];
+    for (int c = 0; c < 3; c++) {
+        cells[c] = ramp->ch[c][PROFILE_SAMPLE_ENTRY] >> PROFILE_CELL_SHIFT;
+    }
+    uint64_t key = RampKey(cells);
+
+    int rounded = PROFILE_UNKNOWN;
+    for (uint32_t slot = (uint32_t)key & (PROFILE_RAMP_SLOTS - 1);
+         index->rampSlots[slot].profile != 0;
+         slot = (slot + 1) & (PROFILE_RAMP_SLOTS - 1)) {
+        if (index->rampSlots[slot].fingerprint != key) continue;
+
+        int i = index->rampSlots[slot].profile - 1;
+        if (matchColor && !MatchesColorSettings(index, i, vibranceRaw, dvcMax, hue)) continue;
+        if (GammaRampsMatch(&index->ramps[i], ramp, 0)) return i;
+        if ((rounded == PROFILE_UNKNOWN || i < rounded) &&
+            GammaRampsMatch(&index->ramps[i], ramp, DEFAULT_RAMP_TOLERANCE)) {
+            rounded = i;
+        }
+    }
+    return rounded;
+}
+
+/*
+ * Profile matching the given display settings
+ */
+int FindProfile(const ProfileIndex* index, int vibranceRaw, int dvcMax, int hue, const GammaRamp* ramp) {
+    return ProbeRampTable(index, ramp, true, vibranceRaw, dvcMax, hue);
+}
+
+/*
+ * Profile whose own gamma ramp is the given one
+ */
+int FindProfileRamp(const ProfileIndex* index, const GammaRamp* ramp) {
+    return ProbeRampTable(index, ramp, false, 0, 0, 0);
+}
+
+/*
+ * Fingerprint of a profile's hue and ramp
+ */
+uint64_t GetProfileFingerprint(const ProfileIndex* index, int profile) {
+    if (profile < 0 || profile >= index->count) return 0;
+    return Fingerprint(index->profiles[profile].hue, &index->ramps[profile]);
+}
+
+/*
+ * Profile with the given fingerprint
+ */
+int FindProfileByFingerprint(const ProfileIndex* index, uint64_t fingerprint) {
+    if (fingerprint == 0) return PROFILE_UNKNOWN;
+    for (uint32_t slot = (uint32_t)fingerprint & (PROFILE_INDEX_SLOTS - 1);
+         index->slots[slot].profile != 0;
+         slot = (slot + 1) & (PROFILE_INDEX_SLOTS - 1)) {
+        if (index->slots[slot].fingerprint == fingerprint) return index->slots[slot].profile - 1;
+    }
+    return PROFILE_UNKNOWN;
+}
+
+/*
+ * Hash of every profile's settings and ramp
+ */
+uint64_t HashProfileIndex(const ProfileIndex* index) {
+    uint64_t hash = HashBytes(FNV1A64_OFFSET, &index->count, sizeof(index->count));
+    for (int i = 0; i < index->count; i++) {
+        /* Field by field: the struct's padding is not initialized */
+        const Profile* profile = &index->profiles[i];
+        hash = HashBytes(hash, profile->name, strlen(profile->name));
+        hash = HashBytes(hash, &profile->vibrance, sizeof(profile->vibrance));
+        hash = HashBytes(hash, &profile->hue, sizeof(profile->hue));
+        hash = HashBytes(hash, &profile->brightness, sizeof(profile->brightness));
+        hash = HashBytes(hash, &profile->contrast, sizeof(profile->contrast));
+        hash = HashBytes(hash, &profile->gamma, sizeof(profile->gamma));
+        hash = HashBytes(hash, &profile->temperature, sizeof(profile->temperature));
+        hash = HashWords(hash, &index->ramps[i], sizeof(index->ramps[i]));
+    }
+    return hash;
+}
+
+/*
+ * Whether any profile moves vibrance or hue off the defaults
+ */
+bool ProfilesUseColorControl(const ProfileIndex* index) {
+    for (int i = 0; i < index->count; i++) {
+        const Profile* profile = &index->profiles[i];
+        if (profile->vibrance != DEFAULT_VIBRANCE_PCT || profile->hue != DEFAULT_HUE) return true;
+    }
+    return false;
+}
+
+/*
+ * Profile that follows current
+ */
+int NextProfile(const ProfileIndex* index, int current) {
+    if (current == PROFILE_DEFAULT) return index->count > 0 ? 0 : PROFILE_DEFAULT;
+    if (current >= 0 && current + 1 < index->count) return current + 1;
+    return PROFILE_DEFAULT;
+}
@@ -0,0 +1,100 @@
+/*
+ * NVCP Toggle - Profile index
+ * The profiles a toggle moves between, with their ramps and two hash tables:
+ * one that identifies the profile a display is on from a ramp read back,
+ * rounded or not, in constant time, and one that finds a profile by its
+ * fingerprint.
+ */
+
+#ifndef NVCP_PROFILE_H
+#define NVCP_PROFILE_H
+
+#include <stdint.h>
+
+#include "nvcp_config.h"
+#include "nvcp_ramp.h"
+
+#define PROFILE_DEFAULT (-1)  /* Driver defaults */
+#define PROFILE_UNKNOWN (-2)  /* Settings that match no profile */
+
+#define PROFILE_INDEX_SLOTS 64  /* Power of two, at least 2 * MAX_PROFILES */
+
+/*
+ * The ramp table keys a ramp on entry PROFILE_SAMPLE_ENTRY of each channel,
+ * cut into cells of 1 << PROFILE_CELL_SHIFT, more than twice the readback
+ * tolerance: a value read back is in the written value's cell or the next,
+ * so a profile is filed under at most two cells per channel.
+ */
+#define PROFILE_SAMPLE_ENTRY 64
+#define PROFILE_CELL_SHIFT   10
+#define PROFILE_RAMP_KEYS    8    /* Per profile: two cells in each of three channels */
+#define PROFILE_RAMP_SLOTS   512  /* Power of two, at least 2 * PROFILE_RAMP_KEYS * MAX_PROFILES */
+
+/* Hash table slot; profile is the index + 1, 0 = empty */
+typedef struct {
+    uint64_t fingerprint;  /* Or the ramp key, in the ramp table */
+    int profile;
+} ProfileSlot;
+
+typedef struct {
+    int count;
+    Profile profiles[MAX_PROFILES];
+    GammaRamp ramps[MAX_PROFILES];
+    ProfileSlot slots[PROFILE_INDEX_SLOTS];     /* By fingerprint */
+    ProfileSlot rampSlots[PROFILE_RAMP_SLOTS];  /* By ramp key */
+} ProfileIndex;
+
+/*
+ * Empty the index
+ */
+void InitProfileIndex(ProfileIndex* index);
+
+/*
+ * Add a profile and the ramp built for it. Returns false when the index is full.
+ */
+bool AddProfile(ProfileIndex* index, const Profile* profile, const GammaRamp* ramp);
+
+/*
+ * Profile whose hue is the given one, whose vibrance (raw DVC) is within 1
+ * of vibranceRaw and whose gamma ramp is the given one, exactly or else
+ * within readback rounding (DEFAULT_RAMP_TOLERANCE); PROFILE_UNKNOWN if none
+ */
+int FindProfile(const ProfileIndex* index, int vibranceRaw, int dvcMax, int hue, const GammaRamp* ramp);
+
+/*
+ * Profile whose own gamma ramp is the given one within readback rounding,
+ * whatever its vibrance and hue; PROFILE_UNKNOWN if none
+ */
+int FindProfileRamp(const ProfileIndex* index, const GammaRamp* ramp);
+
+/*
+ * Fingerprint of a profile's hue and ramp, which stays valid across config
+ * changes that renumber profiles (profiles differing only in vibrance share
+ * one); 0 for PROFILE_DEFAULT
+ */
+uint64_t GetProfileFingerprint(const ProfileIndex* index, int profile);
+
+/*
+ * First profile with the given fingerprint, PROFILE_UNKNOWN if none (as for 0)
+ */
+int FindProfileByFingerprint(const ProfileIndex* index, uint64_t fingerprint);
+
+/*
+ * Hash of every profile's settings and ramp, identifying the index across
+ * runs (profile numbers stored elsewhere are only meaningful against it)
+ */
+uint64_t HashProfileIndex(const ProfileIndex* index);
+
+/*
+ * Whether any profile moves vibrance or hue off the defaults, i.e. whether
+ * toggling needs NVAPI at all
+ */
+bool ProfilesUseColorControl(const ProfileIndex* index);
+
+/*
+ * Profile that follows current: defaults, then each profile in order,
+ * then back to defaults. Unknown settings go back to defaults.
+ */
+int NextProfile(const ProfileIndex* index, int current);
+
+#endif /* NVCP_PROFILE_H */
@@ -0,0 +1,455 @@
+/*
+ * NVCP Toggle - Gamma ramp construction
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_ramp.h"
+#include "nvcp_ramp_kernels.h"
+
+/* SSE2 is baseline on x64 and the MSVC x86 default; NEON on arm64 */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RAMP_COMPARE_SSE2 1
+#elif defined(NVCP_ARCH_ARM64)
+#include <arm_neon.h>
+#define RAMP_COMPARE_NEON 1
+#endif
+
+/* Gamma range the vectorized kernels are validated for; others use the reference */
+#define KERNEL_MIN_GAMMA 0.1
+#define KERNEL_MAX_GAMMA 10.0
+
+/* Settings the kernels handle: the gamma range above, brightness and contrast in
+ * [0, 1] (the fixed engine's Q30 products overflow from contrast 4). NaN fails too. */
+#define KERNEL_HANDLES(brightness, contrast, gamma)                          \
+    ((gamma) >= KERNEL_MIN_GAMMA && (gamma) <= KERNEL_MAX_GAMMA &&           \
+     (brightness) >= 0.0 && (brightness) <= 1.0 && (contrast) >= 0.0 && (contrast) <= 1.0)
+
+typedef struct {
+    const char* name;
+    GammaRampKernel kernel;            /* NULL = scalar double reference */
+    SizedGammaRampKernel sizedKernel;  /* High-resolution sizes, NULL = reference */
+    bool (*supported)(void);           /* NULL = always available */
+} RampKernelEntry;
+
+/* Ordered by preference: the first supported entry is the default */
+static const RampKernelEntry rampKernels[] = {
+#ifdef NVCP_ARCH_X86
+    { "avx2", BuildGammaRampAvx2, BuildSizedGammaRampAvx2, CpuHasAvx2 },
+    { "sse2", BuildGammaRampSse2, BuildSizedGammaRampSse2, CpuHasSse2 },
+#endif
+#ifdef NVCP_ARCH_ARM64
+    { "neon", BuildGammaRampNeon, BuildSizedGammaRampNeon, NULL },
+#endif
+    { "fixed", BuildGammaRampFixed, NULL, NULL },  /* Its log2 table covers 256 entries only */
+    { "reference", NULL, NULL, NULL },
+};
+
+#define RAMP_KERNEL_COUNT (sizeof(rampKernels) / sizeof(rampKernels[0]))
+
+static const RampKernelEntry* activeKernel = NULL;
+
+static bool IsKernelSupported(const RampKernelEntry* entry) {
+    return !entry->supported || entry->supported();
+}
+
+/*
+ * Pick the widest kernel this CPU supports
+ */
+static const RampKernelEntry* SelectDefaultKernel(void) {
+    for (size_t i = 0; i < RAMP_KERNEL_COUNT; i++) {
+        if (IsKernelSupported(&rampKernels[i])) return &rampKernels[i];
+    }
+    return &rampKernels[RAMP_KERNEL_COUNT - 1];
+}
+
+static const RampKernelEntry* GetActiveKernel(void) {
+    if (!activeKernel) {
+        activeKernel = SelectDefaultKernel();
+    }
+    return activeKernel;
+}
+
+/*
+ * Force a specific ramp kernel by name
+ */
+bool SetGammaRampKernel(const char* name) {
+    if (strcmp(name, "auto") == 0) {
+        activeKernel = SelectDefaultKernel();
+        return true;
+    }
+
+    for (size_t i = 0; i < RAMP_KERNEL_COUNT; i++) {
+        if (strcmp(name, rampKernels[i].name) == 0 && IsKernelSupported(&rampKernels[i])) {
+            activeKernel = &rampKernels[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Name of the kernel BuildGammaRamp currently dispatches to
+ */
+const char* GetGammaRampKernelName(void) {
+    return GetActiveKernel()->name;
+}
+
+/*
+ * Blackbody white points, 1900 K to 10000 K in 100 K steps: red, green and
+ * blue gains that turn the display's 6500 K white into a blackbody's white at
+ * that temperature, scaled so the strongest channel is 1 (nothing clips) and
+ * encoded for a 2.2 display gamma so they multiply ramp entries directly.
+ *
+ * Generated offline: Planckian locus chromaticity (Kim et al. cubic fit),
+ * XYZ at Y = 1 to linear sRGB, negative components clamped to 0, divided by
+ * the 6500 K value, normalized to the largest channel, then raised to 1/2.2.
+ */
+static const double BLACKBODY_GAINS[][3] = {
+    { 1.000000, 0.528208, 0.000000 },  /*  1900 K */
+    { 1.000000, 0.552914, 0.111272 },  /*  2000 K */
+    { 1.000000, 0.576178, 0.159530 },  /*  2100 K */
+    { 1.000000, 0.598021, 0.198882 },  /*  2200 K */
+    { 1.000000, 0.618634, 0.233749 },  /*  2300 K */
+    { 1.000000, 0.638072, 0.265878 },  /*  2400 K */
+    { 1.000000, 0.656410, 0.296081 },  /*  2500 K */
+    { 1.000000, 0.673734, 0.324796 },  /*  2600 K */
+    { 1.000000, 0.690127, 0.352295 },  /*  2700 K */
+    { 1.000000, 0.705667, 0.378760 },  /*  2800 K */
+    { 1.000000, 0.720425, 0.404321 },  /*  2900 K */
+    { 1.000000, 0.734465, 0.429074 },  /*  3000 K */
+    { 1.000000, 0.747846, 0.453096 },  /*  3100 K */
+    { 1.000000, 0.760622, 0.476447 },  /*  3200 K */
+    { 1.000000, 0.772839, 0.499180 },  /*  3300 K */
+    { 1.000000, 0.784542, 0.521336 },  /*  3400 K */
+    { 1.000000, 0.795770, 0.542952 },  /*  3500 K */
+    { 1.000000, 0.806558, 0.564063 },  /*  3600 K */
+    { 1.000000, 0.816938, 0.584695 },  /*  3700 K */
+    { 1.000000, 0.826940, 0.604876 },  /*  3800 K */
+    { 1.000000, 0.836588, 0.624629 },  /*  3900 K */
+    { 1.000000, 0.845909, 0.643975 },  /*  4000 K */
+    { 1.000000, 0.855144, 0.663087 },  /*  4100 K */
+    { 1.000000, 0.863925, 0.681433 },  /*  4200 K */
+    { 1.000000, 0.872389, 0.699326 },  /*  4300 K */
+    { 1.000000, 0.880549, 0.716780 },  /*  4400 K */
+    { 1.000000, 0.888418, 0.733804 },  /*  4500 K */
+    { 1.000000, 0.896006, 0.750410 },  /*  4600 K */
+    { 1.000000, 0.903325, 0.766610 },  /*  4700 K */
+    { 1.000000, 0.910387, 0.782414 },  /*  4800 K */
+    { 1.000000, 0.917202, 0.797833 },  /*  4900 K */
+    { 1.000000, 0.923780, 0.812877 },  /*  5000 K */
+    { 1.000000, 0.930132, 0.827557 },  /*  5100 K */
+    { 1.000000, 0.936267, 0.841882 },  /*  5200 K */
+    { 1.000000, 0.942194, 0.855863 },  /*  5300 K */
+    { 1.000000, 0.947923, 0.869509 },  /*  5400 K */
+    { 1.000000, 0.953462, 0.882829 },  /*  5500 K */
+    { 1.000000, 0.958819, 0.895832 },  /*  5600 K */
+    { 1.000000, 0.964002, 0.908527 },  /*  5700 K */
+    { 1.000000, 0.969018, 0.920924 },  /*  5800 K */
+    { 1.000000, 0.973873, 0.933029 },  /*  5900 K */
+    { 1.000000, 0.978576, 0.944852 },  /*  6000 K */
+    { 1.000000, 0.983131, 0.956401 },  /*  6100 K */
+    { 1.000000, 0.987546, 0.967682 },  /*  6200 K */
+    { 1.000000, 0.991825, 0.978705 },  /*  6300 K */
+    { 1.000000, 0.995975, 0.989475 },  /*  6400 K */
+    { 1.000000, 1.000000, 1.000000 },  /*  6500 K */
+    { 0.989818, 0.993684, 1.000000 },  /*  6600 K */
+    { 0.980063, 0.987606, 1.000000 },  /*  6700 K */
+    { 0.970710, 0.981755, 1.000000 },  /*  6800 K */
+    { 0.961737, 0.976118, 1.000000 },  /*  6900 K */
+    { 0.953120, 0.970683, 1.000000 },  /*  7000 K */
+    { 0.944842, 0.965441, 1.000000 },  /*  7100 K */
+    { 0.936882, 0.960381, 1.000000 },  /*  7200 K */
+    { 0.929223, 0.955496, 1.000000 },  /*  7300 K */
+    { 0.921851, 0.950775, 1.000000 },  /*  7400 K */
+    { 0.914749, 0.946212, 1.000000 },  /*  7500 K */
+    { 0.907903, 0.941799, 1.000000 },  /*  7600 K */
+    { 0.901301, 0.937529, 1.000000 },  /*  7700 K */
+    { 0.894931, 0.933395, 1.000000 },  /*  7800 K */
+    { 0.888780, 0.929391, 1.000000 },  /*  7900 K */
+    { 0.882839, 0.925512, 1.000000 },  /*  8000 K */
+    { 0.877097, 0.921752, 1.000000 },  /*  8100 K */
+    { 0.871545, 0.918105, 1.000000 },  /*  8200 K */
+    { 0.866174, 0.914567, 1.000000 },  /*  8300 K */
+    { 0.860976, 0.911134, 1.000000 },  /*  8400 K */
+    { 0.855943, 0.907800, 1.000000 },  /*  8500 K */
+    { 0.851067, 0.904562, 1.000000 },  /*  8600 K */
+    { 0.846342, 0.901417, 1.000000 },  /*  8700 K */
+    { 0.841761, 0.898359, 1.000000 },  /*  8800 K */
+    { 0.837318, 0.895387, 1.000000 },  /*  8900 K */
+    { 0.833007, 0.892495, 1.000000 },  /*  9000 K */
+    { 0.828823, 0.889683, 1.000000 },  /*  9100 K */
+    { 0.824760, 0.886945, 1.000000 },  /*  9200 K */
+    { 0.820813, 0.884280, 1.000000 },  /*  9300 K */
+    { 0.816978, 0.881684, 1.000000 },  /*  9400 K */
+    { 0.813250, 0.879156, 1.000000 },  /*  9500 K */
+    { 0.809625, 0.876693, 1.000000 },  /*  9600 K */
+    { 0.806099, 0.874292, 1.000000 },  /*  9700 K */
+    { 0.802668, 0.871951, 1.000000 },  /*  9800 K */
+    { 0.799328, 0.869668, 1.000000 },  /*  9900 K */
+    { 0.796077, 0.867441, 1.000000 },  /* 10000 K */
+};
+
+#define BLACKBODY_STEP_KELVIN 100
+
+/*
+ * Red, green and blue gains for a temperature setting
+ */
+void GetTemperatureGains(int temperature, double gains[3]) {
+    if (temperature < TEMPERATURE_MIN_KELVIN) {
+        /* Tint: warm boosts red, reduces blue; cool does the opposite */
+        double tempFactor = temperature / 100.0;  /* -1.0 to +1.0 */
+        gains[0] = 1.0 + (tempFactor * 0.1);   /* Warm: +10% red max */
+        gains[1] = 1.0 + (tempFactor * 0.02);  /* Slight green shift for natural warmth */
+        gains[2] = 1.0 - (tempFactor * 0.1);   /* Warm: -10% blue max */
+        return;
+    }
+
+    /* Kelvin: interpolate between the two nearest table rows */
+    int kelvin = temperature > TEMPERATURE_MAX_KELVIN ? TEMPERATURE_MAX_KELVIN : temperature;
+    int row = (kelvin - TEMPERATURE_MIN_KELVIN) / BLACKBODY_STEP_KELVIN;
+    int next = kelvin < TEMPERATURE_MAX_KELVIN ? row + 1 : row;
+    double t = (double)((kelvin - TEMPERATURE_MIN_KELVIN) % BLACKBODY_STEP_KELVIN) / BLACKBODY_STEP_KELVIN;
+    for (int c = 0; c < 3; c++) {
+        gains[c] = BLACKBODY_GAINS[row][c] + (BLACKBODY_GAINS[next][c] - BLACKBODY_GAINS[row][c]) * t;
+    }
+}
+
+/*
+ * Fold BuildGammaRamp inputs into kernel parameters
+ */
+static void GetKernelParams(RampKernelParams* params, double brightness, double contrast, double gamma,
+                            int temperature) {
+    GetTemperatureGains(temperature, params->channelGain);
+    params->applyGamma = (gamma != 1.0);
+    params->invGamma = (float)(1.0 / gamma);
+    params->contrastScale = (float)(contrast * 2.0);
+    params->offset = (float)(brightness - contrast);
+    for (int c = 0; c < 3; c++) {
+        params->channelScale[c] = (float)params->channelGain[c];
+    }
+    params->brightness = brightness;
+    params->contrast = contrast;
+    params->gamma = gamma;
+}
+
+/*
+ * Build gamma ramp using the selected kernel
+ */
+void BuildGammaRamp(GammaRamp* ramp, double brightness, double contrast, double gamma, int temperature) {
+    const RampKernelEntry* entry = GetActiveKernel();
+    if (!entry->kernel || !KERNEL_HANDLES(brightness, contrast, gamma)) {
+        BuildGammaRampReference(ramp, brightness, contrast, gamma, temperature);
+        return;
+    }
+
+    RampKernelParams params;
+    GetKernelParams(&params, brightness, contrast, gamma, temperature);
+    entry->kernel(ramp, &params);
+}
+
+/*
+ * Scalar reference for channels of size entries each, one after another;
+ * size is constant at every call site
+ */
+static NVCP_INLINE void BuildRampReference(uint16_t* ch, int size, double brightness, double contrast,
+                                           double gamma, int temperature) {
+    /* Per-channel temperature gains: a tint or a blackbody white point */
+    double gains[3];
+    GetTemperatureGains(temperature, gains);
+    double redAdj = gains[0];
+    double greenAdj = gains[1];
+    double blueAdj = gains[2];
+
+    for (int i = 0; i < size; i++) {
+        /* Normalize to 0-1 */
+        double value = (double)i / (double)(size - 1);
+
+        /* Apply gamma correction */
+        if (gamma != 1.0) {
+            value = pow(value, 1.0 / gamma);
+        }
+
+        /* Apply brightness and contrast */
+        /* brightness: 0.5 = normal, contrast: 0.5 = normal */
+        value = (value - 0.5) * (contrast * 2.0) + 0.5 + (brightness - 0.5);
+
+        /* Clamp base value to [0, 1] */
+        if (value < 0.0) value = 0.0;
+        if (value > 1.0) value = 1.0;
+
+        /* Apply temperature per channel */
+        double r = value * redAdj;
+        double g = value * greenAdj;
+        double b = value * blueAdj;
+
+        /* Clamp each channel */
+        if (r > 1.0) r = 1.0;
+        if (g > 1.0) g = 1.0;
+        if (b > 1.0) b = 1.0;
+
+        /* Scale to 16-bit with proper rounding */
+        ch[i] = (uint16_t)(r * 65535.0 + 0.5);            /* Red */
+        ch[size + i] = (uint16_t)(g * 65535.0 + 0.5);     /* Green */
+        ch[2 * size + i] = (uint16_t)(b * 65535.0 + 0.5); /* Blue */
+    }
+}
+
+/*
+ * Build gamma ramp from brightness, contrast, gamma, and temperature values
+ * Temperature: -100 (cool/blue) to +100 (warm/yellow)
+ * Scalar double precision; the reference the vectorized kernels are checked against
+ */
+void BuildGammaRampReference(GammaRamp* ramp, double brightness, double contrast, double gamma, int temperature) {
+    BuildRampReference(&ramp->ch[0][0], GAMMA_RAMP_SIZE, brightness, contrast, gamma, temperature);
+}
+
+/*
+ * High-resolution ramp with the selected kernel, or the reference where the
+ * kernel has no high-resolution form
+ */
+static void BuildSizedRamp(uint16_t* ch, int size, double brightness, double contrast, double gamma,
+                           int temperature) {
+    const RampKernelEntry* entry = GetActiveKernel();
+    if (entry->sizedKernel && KERNEL_HANDLES(brightness, contrast, gamma)) {
+        RampKernelParams params;
+        GetKernelParams(&params, brightness, contrast, gamma, temperature);
+        entry->sizedKernel(ch, size, &params);
+    } else if (size == GAMMA_RAMP_SIZE_1024) {
+        BuildRampReference(ch, GAMMA_RAMP_SIZE_1024, brightness, contrast, gamma, temperature);
+    } else {
+        BuildRampReference(ch, GAMMA_RAMP_SIZE_4096, brightness, contrast, gamma, temperature);
+    }
+}
+
+void BuildGammaRamp1024(GammaRamp1024* ramp, double brightness, double contrast, double gamma, int temperature) {
+    BuildSizedRamp(&ramp->ch[0][0], GAMMA_RAMP_SIZE_1024, brightness, contrast, gamma, temperature);
+}
+
+void BuildGammaRamp4096(GammaRamp4096* ramp, double brightness, double contrast, double gamma, int temperature) {
+    BuildSizedRamp(&ramp->ch[0][0], GAMMA_RAMP_SIZE_4096, brightness, contrast, gamma, temperature);
+}
+
+/*
+ * Source value at position index + frac / 255, between entries index and
+ * index + 1. Linear between the two, except where one neighbouring segment is
+ * flat (a clamp at 0 or full scale) and the other is not: the kink is then
+ * inside this interval, and the sloped side is extended up to the flat
+ * value, which is exact for the piecewise-linear clamp instead of cutting
+ * the corner by up to half a source step.
+ */
+static NVCP_INLINE uint16_t SampleRamp(const uint16_t* src, int size, uint32_t index, uint32_t frac) {
+    int32_t a = src[index];
+    int32_t b = src[index + 1];
+    int32_t linear = (int32_t)((a * (255 - (int32_t)frac) + b * (int32_t)frac + 127) / 255);
+    if (a == b || index == 0 || (int)index + 2 >= size) return (uint16_t)linear;
+
+    int32_t before = src[index - 1];
+    int32_t after = src[index + 2];
+    if (b == after && before != a) {
+        /* Flat from index + 1 on: extend the rise into index from the left */
+        int32_t extended = a + (int32_t)(((a - before) * (int32_t)frac + 127) / 255);
+        if (extended > b) extended = b;
+        return (uint16_t)(extended > linear ? extended : linear);
+    }
+    if (before == a && b != after) {
+        /* Flat up to index: extend the rise out of index + 1 back to the right */
+        int32_t extended = b - (int32_t)(((after - b) * (255 - (int32_t)frac) + 127) / 255);
+        if (extended < a) extended = a;
+        return (uint16_t)(extended < linear ? extended : linear);
+    }
+    return (uint16_t)linear;
+}
+
+/*
+ * Sample a ramp of size entries per channel at the 256 device positions.
+ * Device entry i sits at i * (size - 1) / 255 in the source, between two
+ * entries; it is interpolated in integer math with rounding. size is
+ * constant at every call site, so the index math folds into multiplies.
+ */
+static NVCP_INLINE void DownsampleRamp(const uint16_t* in, int size, GammaRamp* out) {
+    for (int c = 0; c < 3; c++) {
+        const uint16_t* src = in + c * size;
+        for (int i = 0; i < GAMMA_RAMP_SIZE - 1; i++) {
+            uint32_t position = (uint32_t)i * (uint32_t)(size - 1);
+            out->ch[c][i] = SampleRamp(src, size, position / 255, position % 255);
+        }
+        out->ch[c][GAMMA_RAMP_SIZE - 1] = src[size - 1];
+    }
+}
+
+void DownsampleGammaRamp1024(const GammaRamp1024* in, GammaRamp* out) {
+    DownsampleRamp(&in->ch[0][0], GAMMA_RAMP_SIZE_1024, out);
+}
+
+void DownsampleGammaRamp4096(const GammaRamp4096* in, GammaRamp* out) {
+    DownsampleRamp(&in->ch[0][0], GAMMA_RAMP_SIZE_4096, out);
+}
+
+/* Identity ramp: entry i = i * 257, i.e. round(i / 255 * 65535) */
+#define IDENTITY_1(i)   (uint16_t)((i) * 257)
+#define IDENTITY_4(i)   IDENTITY_1(i), IDENTITY_1(i + 1), IDENTITY_1(i + 2), IDENTITY_1(i + 3)
+#define IDENTITY_16(i)  IDENTITY_4(i), IDENTITY_4(i + 4), IDENTITY_4(i + 8), IDENTITY_4(i + 12)
+#define IDENTITY_64(i)  IDENTITY_16(i), IDENTITY_16(i + 16), IDENTITY_16(i + 32), IDENTITY_16(i + 48)
+#define IDENTITY_256    IDENTITY_64(0), IDENTITY_64(64), IDENTITY_64(128), IDENTITY_64(192)
+
+const GammaRamp DefaultGammaRamp = {{ { IDENTITY_256 }, { IDENTITY_256 }, { IDENTITY_256 } }};
+
+/*
+ * Check if every entry of two ramps differs by at most tolerance.
+ * Scans 32 entries (64 bytes) per step and stops at the first block that
+ * exceeds the tolerance.
+ */
+bool GammaRampsMatch(const GammaRamp* a, const GammaRamp* b, uint16_t tolerance) {
+    const uint16_t* pa = &a->ch[0][0];
+    const uint16_t* pb = &b->ch[0][0];
+    const int count = 3 * GAMMA_RAMP_SIZE;
+
+#if defined(RAMP_COMPARE_SSE2)
+    const __m128i tol = _mm_set1_epi16((short)tolerance);
+    for (int i = 0; i < count; i += 32) {
+        __m128i over = _mm_setzero_si128();
+        for (int j = 0; j < 32; j += 8) {
+            __m128i va = _mm_loadu_si128((const __m128i*)(pa + i + j));
+            __m128i vb = _mm_loadu_si128((const __m128i*)(pb + i + j));
+            /* |a - b| via two saturating subtracts, then the excess over tolerance */
+            __m128i diff = _mm_or_si128(_mm_subs_epu16(va, vb), _mm_subs_epu16(vb, va));
+            over = _mm_or_si128(over, _mm_subs_epu16(diff, tol));
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(over, _mm_setzero_si128())) != 0xFFFF) {
+            return false;
+        }
+    }
+#elif defined(RAMP_COMPARE_NEON)
+    const uint16x8_t tol = vdupq_n_u16(tolerance);
+    for (int i = 0; i < count; i += 32) {
+        uint16x8_t over = vdupq_n_u16(0);
+        for (int j = 0; j < 32; j += 8) {
+            uint16x8_t diff = vabdq_u16(vld1q_u16(pa + i + j), vld1q_u16(pb + i + j));
+            over = vorrq_u16(over, vqsubq_u16(diff, tol));
+        }
+        if (vmaxvq_u16(over) != 0) {
+            return false;
+        }
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        if (abs((int)pa[i] - (int)pb[i]) > tolerance) {
+            return false;
+        }
+    }
+#endif
+
+    return true;
+}
+
+/*
+ * Check if a ramp matches the default (linear) ramp within readback tolerance
+ */
+bool IsDefaultGammaRamp(const GammaRamp* ramp) {
+    /* Allow small tolerance for driver rounding on readback */
+    return GammaRampsMatch(ramp, &DefaultGammaRamp, DEFAULT_RAMP_TOLERANCE);
+}
@@ -0,0 +1,112 @@
+/*
+ * NVCP Toggle - Gamma ramp construction
+ * Portable ramp math shared by the Windows tool and the stand-in build
+ */
+
+#ifndef NVCP_RAMP_H
+#define NVCP_RAMP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GAMMA_RAMP_SIZE 256
+
+/* Device gamma ramp, same layout as the GDI WORD[3][256] red/green/blue array */
+typedef struct {
+    uint16_t ch[3][GAMMA_RAMP_SIZE];
+} GammaRamp;
+
+/* Temperatures from TEMPERATURE_MIN_KELVIN up are a blackbody white point in K */
+#define TEMPERATURE_MIN_KELVIN 1900
+#define TEMPERATURE_MAX_KELVIN 10000
+
+/*
+ * Red, green and blue gains for a temperature: -100 (cool/blue) to +100
+ * (warm/yellow) scales red and blue by up to 10% either way; a Kelvin value
+ * is interpolated from a blackbody table, 6500 K being neutral and the
+ * strongest channel always 1
+ */
+void GetTemperatureGains(int temperature, double gains[3]);
+
+/*
+ * Build gamma ramp from brightness, contrast, gamma, and temperature values
+ * Temperature: -100 (cool/blue) to +100 (warm/yellow), or a white point in
+ * Kelvin (TEMPERATURE_MIN_KELVIN to TEMPERATURE_MAX_KELVIN)
+ * Dispatches to the fastest kernel for this CPU (AVX2, SSE2 or NEON, else the
+ * fixed-point engine); results are within 1 LSB of BuildGammaRampReference.
+ */
+void BuildGammaRamp(GammaRamp* ramp, double brightness, double contrast, double gamma, int temperature);
+
+/*
+ * Scalar double precision ramp builder, kept as the reference implementation
+ */
+void BuildGammaRampReference(GammaRamp* ramp, double brightness, double contrast, double gamma, int temperature);
+
+/*
+ * Force a specific ramp kernel: "auto", "avx2", "sse2", "neon", "fixed"
+ * (integer-only, bit-identical everywhere) or "reference" (scalar double).
+ * Returns false if the kernel isn't available on this CPU.
+ */
+bool SetGammaRampKernel(const char* name);
+
+/*
+ * Name of the kernel BuildGammaRamp currently dispatches to
+ */
+const char* GetGammaRampKernelName(void);
+
+/* High-resolution ramps for exports, previews and composition; the device takes GammaRamp */
+#define GAMMA_RAMP_SIZE_1024 1024
+#define GAMMA_RAMP_SIZE_4096 4096
+
+typedef struct {
+    uint16_t ch[3][GAMMA_RAMP_SIZE_1024];
+} GammaRamp1024;
+
+typedef struct {
+    uint16_t ch[3][GAMMA_RAMP_SIZE_4096];
+} GammaRamp4096;
+
+/*
+ * BuildGammaRamp at 1024 or 4096 entries per channel, entry i at input
+ * i / (size - 1). Uses the selected vectorized kernel, compiled separately for
+ * each size; the fixed and reference engines use the scalar reference.
+ */
+void BuildGammaRamp1024(GammaRamp1024* ramp, double brightness, double contrast, double gamma, int temperature);
+void BuildGammaRamp4096(GammaRamp4096* ramp, double brightness, double contrast, double gamma, int temperature);
+
+/*
+ * Resample a high-resolution ramp to the 256-entry device ramp by linear
+ * interpolation, following clamp kinks exactly; endpoints are kept exactly.
+ * Device entries fall between source entries, so curvature is cut: against
+ * BuildGammaRamp with the same settings, entries are within
+ * DOWNSAMPLE_MAX_LSB_1024 / _4096 up to gamma 1, and within the _STEEP
+ * bounds up to gamma 3, where x^(1/gamma) rises steeply from black and the
+ * first few entries are undersampled.
+ */
+void DownsampleGammaRamp1024(const GammaRamp1024* in, GammaRamp* out);
+void DownsampleGammaRamp4096(const GammaRamp4096* in, GammaRamp* out);
+
+#define DOWNSAMPLE_MAX_LSB_1024       2
+#define DOWNSAMPLE_MAX_LSB_4096       1
+#define DOWNSAMPLE_MAX_LSB_1024_STEEP 24
+#define DOWNSAMPLE_MAX_LSB_4096_STEEP 7
+
+/* Maximum per-entry deviation from DefaultGammaRamp still treated as default */
+#define DEFAULT_RAMP_TOLERANCE 256
+
+/*
+ * Default (linear) ramp, built at compile time: entry i = i * 257
+ */
+extern const GammaRamp DefaultGammaRamp;
+
+/*
+ * Check if every entry of two ramps differs by at most tolerance (vectorized, early exit)
+ */
+bool GammaRampsMatch(const GammaRamp* a, const GammaRamp* b, uint16_t tolerance);
+
+/*
+ * Check if a ramp matches the default (linear) ramp within readback tolerance
+ */
+bool IsDefaultGammaRamp(const GammaRamp* ramp);
+
+#endif /* NVCP_RAMP_H */
@@ -0,0 +1,181 @@
+/*
+ * NVCP Toggle - Persistent ramp cache
+ *
+ * File layout: a header followed by RAMP_CACHE_SLOTS fixed-size entries.
+ * Entries are placed by key hash with a short linear probe. Each entry
+ * carries its own checksum, so a torn or damaged entry reads as a miss and
+ * is rebuilt; a bad header resets the whole file.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "nvcp_hash.h"
+#include "nvcp_ramp_cache.h"
+
+#define RAMP_CACHE_MAGIC   0x4352564Eu  /* "NVRC" */
+#define RAMP_CACHE_VERSION 1
+#define RAMP_CACHE_SLOTS   64
+#define RAMP_CACHE_PROBES  4
+#define RAMP_CACHE_KERNEL_NAME_SIZE 12
+
+struct RampCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t entrySize;
+    uint64_t checksum;  /* Of the fields above */
+};
+
+struct RampCacheEntry {
+    uint64_t key;       /* Hash of the inputs below, 0 = empty slot */
+    double brightness;
+    double contrast;
+    double gamma;
+    int32_t temperature;
+    char kernel[RAMP_CACHE_KERNEL_NAME_SIZE];
+    uint64_t checksum;  /* Of everything above plus the ramp */
+    GammaRamp ramp;
+};
+
+#define RAMP_CACHE_FILE_SIZE \
+    (sizeof(struct RampCacheHeader) + RAMP_CACHE_SLOTS * sizeof(struct RampCacheEntry))
+
+static uint64_t HeaderChecksum(const struct RampCacheHeader* header) {
+    return HashBytes(FNV1A64_OFFSET, header, offsetof(struct RampCacheHeader, checksum));
+}
+
+static uint64_t EntryChecksum(const struct RampCacheEntry* entry) {
+    uint64_t hash = HashWords(FNV1A64_OFFSET, entry, offsetof(struct RampCacheEntry, checksum));
+    return HashWords(hash, &entry->ramp, sizeof(entry->ramp));
+}
+
+/* Inputs of one BuildGammaRamp call, laid out the way entries store them */
+typedef struct {
+    uint64_t key;
+    double brightness;
+    double contrast;
+    double gamma;
+    int32_t temperature;
+    char kernel[RAMP_CACHE_KERNEL_NAME_SIZE];
+} RampCacheKey;
+
+static void MakeKey(RampCacheKey* k, double brightness, double contrast, double gamma, int temperature) {
+    memset(k, 0, sizeof(*k));
+    k->brightness = brightness;
+    k->contrast = contrast;
+    k->gamma = gamma;
+    k->temperature = temperature;
+    /* Kernels may differ by 1 LSB, so ramps are cached per kernel */
+    strncpy(k->kernel, GetGammaRampKernelName(), sizeof(k->kernel) - 1);
+
+    uint64_t hash = HashBytes(FNV1A64_OFFSET, &k->brightness,
+                              offsetof(RampCacheKey, kernel) + sizeof(k->kernel) - offsetof(RampCacheKey, brightness));
+    k->key = hash ? hash : 1;
+}
+
+static bool EntryMatchesKey(const struct RampCacheEntry* entry, const RampCacheKey* k) {
+    return entry->key == k->key &&
+           memcmp(&entry->brightness, &k->brightness, sizeof(double) * 3) == 0 &&
+           entry->temperature == k->temperature &&
+           memcmp(entry->kernel, k->kernel, sizeof(k->kernel)) == 0;
+}
+
+/*
+ * Open (or create) the cache file
+ */
+bool OpenRampCache(const char* path, RampCache* cache) {
+    memset(cache, 0, sizeof(*cache));
+    if (!MapFileWritable(path, RAMP_CACHE_FILE_SIZE, &cache->file)) {
+        return false;
+    }
+
+    cache->header = (struct RampCacheHeader*)cache->file.data;
+    cache->entries = (struct RampCacheEntry*)(cache->header + 1);
+
+    struct RampCacheHeader* header = cache->header;
+    if (header->magic != RAMP_CACHE_MAGIC || header->version != RAMP_CACHE_VERSION ||
+        header->slotCount != RAMP_CACHE_SLOTS || header->entrySize != sizeof(struct RampCacheEntry) ||
+        header->checksum != HeaderChecksum(header)) {
+        /* New, stale or damaged file: start over */
+        memset(cache->file.data, 0, RAMP_CACHE_FILE_SIZE);
+        header->magic = RAMP_CACHE_MAGIC;
+        header->version = RAMP_CACHE_VERSION;
+        header->slotCount = RAMP_CACHE_SLOTS;
+        header->entrySize = sizeof(struct RampCacheEntry);
+        header->checksum = HeaderChecksum(header);
+    }
+
+    return true;
+}
+
+/*
+ * Unmap the cache
+ */
+void CloseRampCache(RampCache* cache) {
+    UnmapFile(&cache->file);
+    cache->header = NULL;
+    cache->entries = NULL;
+}
+
+static const GammaRamp* LookupKey(RampCache* cache, const RampCacheKey* k) {
+    for (uint32_t probe = 0; probe < RAMP_CACHE_PROBES; probe++) {
+        const struct RampCacheEntry* entry = &cache->entries[(k->key + probe) % RAMP_CACHE_SLOTS];
+        if (EntryMatchesKey(entry, k)) {
+            return entry->checksum == EntryChecksum(entry) ? &entry->ramp : NULL;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Find a cached ramp built by the current ramp kernel
+ */
+const GammaRamp* RampCacheLookup(RampCache* cache, double brightness, double contrast,
+                                 double gamma, int temperature) {
+    if (!cache->entries) return NULL;
+
+    RampCacheKey k;
+    MakeKey(&k, brightness, contrast, gamma, temperature);
+    return LookupKey(cache, &k);
+}
+
+/*
+ * Look up the ramp, building and storing it on a miss
+ */
+const GammaRamp* RampCacheGetOrBuild(RampCache* cache, double brightness, double contrast,
+                                     double gamma, int temperature, GammaRamp* scratch) {
+    if (!cache->entries) {
+        BuildGammaRamp(scratch, brightness, contrast, gamma, temperature);
+        return scratch;
+    }
+
+    RampCacheKey k;
+    MakeKey(&k, brightness, contrast, gamma, temperature);
+
+    const GammaRamp* cached = LookupKey(cache, &k);
+    if (cached) return cached;
+
+    /* Reuse this key's slot or an empty one in the probe window, else evict the home slot */
+    struct RampCacheEntry* slot = &cache->entries[k.key % RAMP_CACHE_SLOTS];
+    for (uint32_t probe = 0; probe < RAMP_CACHE_PROBES; probe++) {
+        struct RampCacheEntry* entry = &cache->entries[(k.key + probe) % RAMP_CACHE_SLOTS];
+        if (entry->key == 0 || EntryMatchesKey(entry, &k)) {
+            slot = entry;
+            break;
+        }
+    }
+
+    /* Clear the key first so a concurrent reader never sees a half-written entry as valid */
+    slot->key = 0;
+    BuildGammaRamp(&slot->ramp, brightness, contrast, gamma, temperature);
+    slot->brightness = k.brightness;
+    slot->contrast = k.contrast;
+    slot->gamma = k.gamma;
+    slot->temperature = k.temperature;
+    memcpy(slot->kernel, k.kernel, sizeof(slot->kernel));
+    slot->key = k.key;
+    slot->checksum = EntryChecksum(slot);
+
+    return &slot->ramp;
+}
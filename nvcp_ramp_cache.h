@@ -0,0 +1,49 @@
+/*
+ * NVCP Toggle - Persistent ramp cache
+ * Memory-mapped file of fully built ramps keyed by the BuildGammaRamp inputs,
+ * so a repeated parameter set is a page-mapped lookup instead of a rebuild.
+ */
+
+#ifndef NVCP_RAMP_CACHE_H
+#define NVCP_RAMP_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "nvcp_platform.h"
+#include "nvcp_ramp.h"
+
+#define RAMP_CACHE_FILE_NAME "native_nvcp_ramps.cache"
+
+typedef struct {
+    MappedFile file;
+    struct RampCacheHeader* header;
+    struct RampCacheEntry* entries;
+} RampCache;
+
+/*
+ * Open (or create) the cache file. A file with the wrong magic, version or
+ * layout, or a damaged header, is reset to an empty cache.
+ */
+bool OpenRampCache(const char* path, RampCache* cache);
+
+/*
+ * Unmap the cache; entries are written through the mapping as they are stored
+ */
+void CloseRampCache(RampCache* cache);
+
+/*
+ * Find a cached ramp built by the current ramp kernel. Returns a pointer into
+ * the mapping, or NULL on a miss or a corrupted entry.
+ */
+const GammaRamp* RampCacheLookup(RampCache* cache, double brightness, double contrast,
+                                 double gamma, int temperature);
+
+/*
+ * Look up the ramp, building and storing it on a miss.
+ * Returns a pointer into the mapping, or to scratch if storing failed.
+ */
+const GammaRamp* RampCacheGetOrBuild(RampCache* cache, double brightness, double contrast,
+                                     double gamma, int temperature, GammaRamp* scratch);
+
+#endif /* NVCP_RAMP_CACHE_H */
@@ -0,0 +1,81 @@
+/*
+ * NVCP Toggle - Gamma ramp kernel interface (internal to the ramp module)
+ */
+
+#ifndef NVCP_RAMP_KERNELS_H
+#define NVCP_RAMP_KERNELS_H
+
+#include <stdbool.h>
+
+#include "nvcp_ramp.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NVCP_ARCH_X86 1
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define NVCP_ARCH_ARM64 1
+#endif
+
+/* GCC/Clang need per-function target attributes to emit wider ISAs */
+#if defined(__GNUC__) || defined(__clang__)
+#define NVCP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NVCP_TARGET(isa)
+#endif
+
+/* Kernel bodies are inlined into one copy per ramp size, so each size gets constant bounds */
+#if defined(_MSC_VER)
+#define NVCP_INLINE __forceinline
+#elif defined(__GNUC__) || defined(__clang__)
+#define NVCP_INLINE inline __attribute__((always_inline))
+#else
+#define NVCP_INLINE inline
+#endif
+
+/*
+ * BuildGammaRamp inputs folded into the form the kernels evaluate:
+ *   value = clamp(pow(i / 255, invGamma) * contrastScale + offset, 0, 1)
+ *   out[c] = min(value * channelScale[c], 1) * 65535 + 0.5
+ */
+typedef struct {
+    bool applyGamma;       /* false when gamma == 1.0 (pow skipped, as in the reference) */
+    float invGamma;
+    float contrastScale;   /* contrast * 2 */
+    float offset;          /* brightness - contrast */
+    float channelScale[3]; /* temperature adjustment for red, green, blue */
+
+    /* Original inputs, for engines that derive their own number format */
+    double brightness;
+    double contrast;
+    double gamma;
+    double channelGain[3]; /* GetTemperatureGains */
+} RampKernelParams;
+
+typedef void (*GammaRampKernel)(GammaRamp* ramp, const RampKernelParams* params);
+
+/*
+ * The same for GAMMA_RAMP_SIZE, GAMMA_RAMP_SIZE_1024 or GAMMA_RAMP_SIZE_4096
+ * entries per channel, stored channel after channel; each size is a
+ * separately compiled copy
+ */
+typedef void (*SizedGammaRampKernel)(uint16_t* ch, int size, const RampKernelParams* params);
+
+/* Integer-only engine, bit-identical on every compiler (nvcp_ramp_fixed.c) */
+void BuildGammaRampFixed(GammaRamp* ramp, const RampKernelParams* params);
+
+#ifdef NVCP_ARCH_X86
+bool CpuHasSse2(void);
+bool CpuHasAvx2(void);
+void BuildGammaRampSse2(GammaRamp* ramp, const RampKernelParams* params);
+void BuildGammaRampAvx2(GammaRamp* ramp, const RampKernelParams* params);
+void BuildSizedGammaRampSse2(uint16_t* ch, int size, const RampKernelParams* params);
+void BuildSizedGammaRampAvx2(uint16_t* ch, int size, const RampKernelParams* params);
+#endif
+
+#ifdef NVCP_ARCH_ARM64
+void BuildGammaRampNeon(GammaRamp* ramp, const RampKernelParams* params);
+void BuildSizedGammaRampNeon(uint16_t* ch, int size, const RampKernelParams* params);
+#endif
+
+#endif /* NVCP_RAMP_KERNELS_H */
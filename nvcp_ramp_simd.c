@@ -0,0 +1,377 @@
+/*
+ * NVCP Toggle - Vectorized gamma ramp kernels
+ * SSE2 (8 entries/iteration), AVX2 (16) and NEON (8) versions of the ramp
+ * builder. pow(x, 1/gamma) is evaluated as exp2(log2(x) / gamma) with single
+ * precision polynomials:
+ *   log2: atanh series in s = (m - 1) / (m + 1), m in [sqrt(0.5), sqrt(2)),
+ *         truncation error < 1e-9
+ *   exp2: degree 7 Taylor polynomial on [-0.5, 0.5], relative error < 6e-9
+ * The result is dominated by float rounding (~1e-6 relative), i.e. well
+ * under one 16-bit LSB, so every kernel stays within 1 LSB of the reference.
+ */
+
+#include "nvcp_ramp_kernels.h"
+
+#define LN2      0.69314718056f
+#define LOG2_C1  2.88539008178f  /* 2 / ln(2) */
+#define LOG2_C3  0.96179669393f  /* 2 / (3 ln(2)) */
+#define LOG2_C5  0.57707801636f  /* 2 / (5 ln(2)) */
+#define LOG2_C7  0.41219858311f  /* 2 / (7 ln(2)) */
+#define LOG2_C9  0.32059889797f  /* 2 / (9 ln(2)) */
+#define SQRT2    1.41421356237f
+
+#ifdef NVCP_ARCH_X86
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+/*
+ * CPU feature detection
+ */
+static void Cpuid(int leaf, int subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, leaf, subleaf);
+    for (int i = 0; i < 4; i++) regs[i] = (unsigned)r[i];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static unsigned long long ReadXcr0(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+
+bool CpuHasSse2(void) {
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;  /* Baseline on x86-64 */
+#else
+    unsigned regs[4];
+    Cpuid(1, 0, regs);
+    return (regs[3] & (1u << 26)) != 0;
+#endif
+}
+
+bool CpuHasAvx2(void) {
+    unsigned regs[4];
+    Cpuid(0, 0, regs);
+    if (regs[0] < 7) return false;
+
+    /* AVX needs OSXSAVE and the OS saving XMM/YMM state */
+    Cpuid(1, 0, regs);
+    bool osxsave = (regs[2] & (1u << 27)) != 0;
+    bool avx = (regs[2] & (1u << 28)) != 0;
+    if (!osxsave || !avx || (ReadXcr0() & 0x6) != 0x6) return false;
+
+    Cpuid(7, 0, regs);
+    return (regs[1] & (1u << 5)) != 0;
+}
+
+/*
+ * SSE2 kernel: 4 lanes, two vectors per iteration
+ */
+NVCP_TARGET("sse2")
+static inline __m128 Log2Sse2(__m128 x) {
+    __m128i bits = _mm_castps_si128(x);
+    __m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)),
+                                             _mm_set1_epi32(0x3F800000)));
+
+    /* Fold m into [sqrt(0.5), sqrt(2)) so the series argument stays small */
+    __m128 big = _mm_cmpgt_ps(m, _mm_set1_ps(SQRT2));
+    m = _mm_sub_ps(m, _mm_and_ps(big, _mm_mul_ps(m, _mm_set1_ps(0.5f))));
+    e = _mm_sub_epi32(e, _mm_castps_si128(big));
+
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 s = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+    __m128 s2 = _mm_mul_ps(s, s);
+    __m128 p = _mm_set1_ps(LOG2_C9);
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C7));
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C5));
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C1));
+    return _mm_add_ps(_mm_mul_ps(p, s), _mm_cvtepi32_ps(e));
+}
+
+NVCP_TARGET("sse2")
+static inline __m128 Exp2Sse2(__m128 y) {
+    __m128i n = _mm_cvtps_epi32(y);  /* Round to nearest */
+    __m128 t = _mm_mul_ps(_mm_sub_ps(y, _mm_cvtepi32_ps(n)), _mm_set1_ps(LN2));
+    __m128 p = _mm_set1_ps(1.0f / 5040.0f);
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f / 720.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f / 120.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f / 24.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f / 6.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(0.5f));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f));
+    p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(1.0f));
+    return _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(p), _mm_slli_epi32(n, 23)));
+}
+
+/* Gamma, contrast and brightness for entries idx..idx+3 of size, clamped to [0, 1] */
+NVCP_TARGET("sse2")
+static inline __m128 BaseValueSse2(__m128i idx, int size, const RampKernelParams* params) {
+    __m128 x = _mm_div_ps(_mm_cvtepi32_ps(idx), _mm_set1_ps((float)(size - 1)));
+    if (params->applyGamma) {
+        __m128 nonZero = _mm_cmpgt_ps(x, _mm_setzero_ps());
+        x = _mm_and_ps(nonZero, Exp2Sse2(_mm_mul_ps(Log2Sse2(x), _mm_set1_ps(params->invGamma))));
+    }
+    __m128 v = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(params->contrastScale)), _mm_set1_ps(params->offset));
+    return _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+NVCP_TARGET("sse2")
+static inline __m128i QuantizeSse2(__m128 v, float scale) {
+    __m128 c = _mm_min_ps(_mm_mul_ps(v, _mm_set1_ps(scale)), _mm_set1_ps(1.0f));
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(c, _mm_set1_ps(65535.0f)), _mm_set1_ps(0.5f)));
+}
+
+/* Pack 0..65535 int32 lanes to uint16 (SSE2 only has a signed saturating pack) */
+NVCP_TARGET("sse2")
+static inline __m128i PackU16Sse2(__m128i lo, __m128i hi) {
+    __m128i bias = _mm_set1_epi32(0x8000);
+    __m128i packed = _mm_packs_epi32(_mm_sub_epi32(lo, bias), _mm_sub_epi32(hi, bias));
+    return _mm_xor_si128(packed, _mm_set1_epi16((short)0x8000));
+}
+
+/* Channels of size entries each, one after another; size is constant at every call site */
+NVCP_TARGET("sse2")
+static NVCP_INLINE void BuildRampSse2(uint16_t* ch, int size, const RampKernelParams* params) {
+    __m128i idx = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i step = _mm_set1_epi32(4);
+
+    for (int i = 0; i < size; i += 8) {
+        __m128 v0 = BaseValueSse2(idx, size, params);
+        __m128 v1 = BaseValueSse2(_mm_add_epi32(idx, step), size, params);
+        for (int c = 0; c < 3; c++) {
+            __m128i q0 = QuantizeSse2(v0, params->channelScale[c]);
+            __m128i q1 = QuantizeSse2(v1, params->channelScale[c]);
+            _mm_storeu_si128((__m128i*)&ch[c * size + i], PackU16Sse2(q0, q1));
+        }
+        idx = _mm_add_epi32(idx, _mm_set1_epi32(8));
+    }
+}
+
+NVCP_TARGET("sse2")
+void BuildGammaRampSse2(GammaRamp* ramp, const RampKernelParams* params) {
+    BuildRampSse2(&ramp->ch[0][0], GAMMA_RAMP_SIZE, params);
+}
+
+NVCP_TARGET("sse2")
+void BuildSizedGammaRampSse2(uint16_t* ch, int size, const RampKernelParams* params) {
+    switch (size) {
+    case GAMMA_RAMP_SIZE_1024:
+        BuildRampSse2(ch, GAMMA_RAMP_SIZE_1024, params);
+        break;
+    case GAMMA_RAMP_SIZE_4096:
+        BuildRampSse2(ch, GAMMA_RAMP_SIZE_4096, params);
+        break;
+    default:
+        BuildRampSse2(ch, GAMMA_RAMP_SIZE, params);
+        break;
+    }
+}
+
+/*
+ * AVX2 kernel: 8 lanes, two vectors per iteration
+ */
+NVCP_TARGET("avx2")
+static inline __m256 Log2Avx2(__m256 x) {
+    __m256i bits = _mm256_castps_si256(x);
+    __m256i e = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127));
+    __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                   _mm256_set1_epi32(0x3F800000)));
+
+    __m256 big = _mm256_cmp_ps(m, _mm256_set1_ps(SQRT2), _CMP_GT_OQ);
+    m = _mm256_sub_ps(m, _mm256_and_ps(big, _mm256_mul_ps(m, _mm256_set1_ps(0.5f))));
+    e = _mm256_sub_epi32(e, _mm256_castps_si256(big));
+
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 s = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+    __m256 s2 = _mm256_mul_ps(s, s);
+    __m256 p = _mm256_set1_ps(LOG2_C9);
+    p = _mm256_add_ps(_mm256_mul_ps(p, s2), _mm256_set1_ps(LOG2_C7));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s2), _mm256_set1_ps(LOG2_C5));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s2), _mm256_set1_ps(LOG2_C3));
+    p = _mm256_add_ps(_mm256_mul_ps(p, s2), _mm256_set1_ps(LOG2_C1));
+    return _mm256_add_ps(_mm256_mul_ps(p, s), _mm256_cvtepi32_ps(e));
+}
+
+NVCP_TARGET("avx2")
+static inline __m256 Exp2Avx2(__m256 y) {
+    __m256i n = _mm256_cvtps_epi32(y);
+    __m256 t = _mm256_mul_ps(_mm256_sub_ps(y, _mm256_cvtepi32_ps(n)), _mm256_set1_ps(LN2));
+    __m256 p = _mm256_set1_ps(1.0f / 5040.0f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f / 720.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f / 120.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f / 24.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f / 6.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(0.5f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, t), _mm256_set1_ps(1.0f));
+    return _mm256_castsi256_ps(_mm256_add_epi32(_mm256_castps_si256(p), _mm256_slli_epi32(n, 23)));
+}
+
+NVCP_TARGET("avx2")
+static inline __m256 BaseValueAvx2(__m256i idx, int size, const RampKernelParams* params) {
+    __m256 x = _mm256_div_ps(_mm256_cvtepi32_ps(idx), _mm256_set1_ps((float)(size - 1)));
+    if (params->applyGamma) {
+        __m256 nonZero = _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OQ);
+        x = _mm256_and_ps(nonZero, Exp2Avx2(_mm256_mul_ps(Log2Avx2(x), _mm256_set1_ps(params->invGamma))));
+    }
+    __m256 v = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(params->contrastScale)),
+                             _mm256_set1_ps(params->offset));
+    return _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+}
+
+NVCP_TARGET("avx2")
+static inline __m256i QuantizeAvx2(__m256 v, float scale) {
+    __m256 c = _mm256_min_ps(_mm256_mul_ps(v, _mm256_set1_ps(scale)), _mm256_set1_ps(1.0f));
+    return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(c, _mm256_set1_ps(65535.0f)), _mm256_set1_ps(0.5f)));
+}
+
+NVCP_TARGET("avx2")
+static NVCP_INLINE void BuildRampAvx2(uint16_t* ch, int size, const RampKernelParams* params) {
+    __m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i step = _mm256_set1_epi32(8);
+
+    for (int i = 0; i < size; i += 16) {
+        __m256 v0 = BaseValueAvx2(idx, size, params);
+        __m256 v1 = BaseValueAvx2(_mm256_add_epi32(idx, step), size, params);
+        for (int c = 0; c < 3; c++) {
+            __m256i q0 = QuantizeAvx2(v0, params->channelScale[c]);
+            __m256i q1 = QuantizeAvx2(v1, params->channelScale[c]);
+            /* packus works per 128-bit lane; restore entry order afterwards */
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(q0, q1), 0xD8);
+            _mm256_storeu_si256((__m256i*)&ch[c * size + i], packed);
+        }
+        idx = _mm256_add_epi32(idx, _mm256_set1_epi32(16));
+    }
+}
+
+NVCP_TARGET("avx2")
+void BuildGammaRampAvx2(GammaRamp* ramp, const RampKernelParams* params) {
+    BuildRampAvx2(&ramp->ch[0][0], GAMMA_RAMP_SIZE, params);
+}
+
+NVCP_TARGET("avx2")
+void BuildSizedGammaRampAvx2(uint16_t* ch, int size, const RampKernelParams* params) {
+    switch (size) {
+    case GAMMA_RAMP_SIZE_1024:
+        BuildRampAvx2(ch, GAMMA_RAMP_SIZE_1024, params);
+        break;
+    case GAMMA_RAMP_SIZE_4096:
+        BuildRampAvx2(ch, GAMMA_RAMP_SIZE_4096, params);
+        break;
+    default:
+        BuildRampAvx2(ch, GAMMA_RAMP_SIZE, params);
+        break;
+    }
+}
+
+#endif /* NVCP_ARCH_X86 */
+
+#ifdef NVCP_ARCH_ARM64
+
+#include <arm_neon.h>
+
+/*
+ * NEON kernel: 4 lanes, two vectors per iteration
+ */
+static inline float32x4_t Log2Neon(float32x4_t x) {
+    uint32x4_t bits = vreinterpretq_u32_f32(x);
+    int32x4_t e = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127));
+    float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFF)),
+                                                    vdupq_n_u32(0x3F800000)));
+
+    uint32x4_t big = vcgtq_f32(m, vdupq_n_f32(SQRT2));
+    m = vbslq_f32(big, vmulq_n_f32(m, 0.5f), m);
+    e = vsubq_s32(e, vreinterpretq_s32_u32(big));
+
+    float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t s = vdivq_f32(vsubq_f32(m, one), vaddq_f32(m, one));
+    float32x4_t s2 = vmulq_f32(s, s);
+    float32x4_t p = vdupq_n_f32(LOG2_C9);
+    p = vaddq_f32(vmulq_f32(p, s2), vdupq_n_f32(LOG2_C7));
+    p = vaddq_f32(vmulq_f32(p, s2), vdupq_n_f32(LOG2_C5));
+    p = vaddq_f32(vmulq_f32(p, s2), vdupq_n_f32(LOG2_C3));
+    p = vaddq_f32(vmulq_f32(p, s2), vdupq_n_f32(LOG2_C1));
+    return vaddq_f32(vmulq_f32(p, s), vcvtq_f32_s32(e));
+}
+
+static inline float32x4_t Exp2Neon(float32x4_t y) {
+    int32x4_t n = vcvtnq_s32_f32(y);
+    float32x4_t t = vmulq_n_f32(vsubq_f32(y, vcvtq_f32_s32(n)), LN2);
+    float32x4_t p = vdupq_n_f32(1.0f / 5040.0f);
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(1.0f / 720.0f));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(1.0f / 120.0f));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(1.0f / 24.0f));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(1.0f / 6.0f));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(0.5f));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(1.0f));
+    p = vaddq_f32(vmulq_f32(p, t), vdupq_n_f32(1.0f));
+    return vreinterpretq_f32_s32(vaddq_s32(vreinterpretq_s32_f32(p), vshlq_n_s32(n, 23)));
+}
+
+static inline float32x4_t BaseValueNeon(uint32x4_t idx, int size, const RampKernelParams* params) {
+    float32x4_t x = vdivq_f32(vcvtq_f32_u32(idx), vdupq_n_f32((float)(size - 1)));
+    if (params->applyGamma) {
+        uint32x4_t nonZero = vcgtq_f32(x, vdupq_n_f32(0.0f));
+        float32x4_t y = Exp2Neon(vmulq_n_f32(Log2Neon(x), params->invGamma));
+        x = vreinterpretq_f32_u32(vandq_u32(nonZero, vreinterpretq_u32_f32(y)));
+    }
+    float32x4_t v = vaddq_f32(vmulq_n_f32(x, params->contrastScale), vdupq_n_f32(params->offset));
+    return vminq_f32(vmaxq_f32(v, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+}
+
+static inline uint16x4_t QuantizeNeon(float32x4_t v, float scale) {
+    float32x4_t c = vminq_f32(vmulq_n_f32(v, scale), vdupq_n_f32(1.0f));
+    return vmovn_u32(vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(c, 65535.0f), vdupq_n_f32(0.5f))));
+}
+
+static NVCP_INLINE void BuildRampNeon(uint16_t* ch, int size, const RampKernelParams* params) {
+    static const uint32_t base[4] = {0, 1, 2, 3};
+    uint32x4_t idx = vld1q_u32(base);
+    uint32x4_t step = vdupq_n_u32(4);
+
+    for (int i = 0; i < size; i += 8) {
+        float32x4_t v0 = BaseValueNeon(idx, size, params);
+        float32x4_t v1 = BaseValueNeon(vaddq_u32(idx, step), size, params);
+        for (int c = 0; c < 3; c++) {
+            uint16x8_t q = vcombine_u16(QuantizeNeon(v0, params->channelScale[c]),
+                                        QuantizeNeon(v1, params->channelScale[c]));
+            vst1q_u16(&ch[c * size + i], q);
+        }
+        idx = vaddq_u32(idx, vdupq_n_u32(8));
+    }
+}
+
+void BuildGammaRampNeon(GammaRamp* ramp, const RampKernelParams* params) {
+    BuildRampNeon(&ramp->ch[0][0], GAMMA_RAMP_SIZE, params);
+}
+
+void BuildSizedGammaRampNeon(uint16_t* ch, int size, const RampKernelParams* params) {
+    switch (size) {
+    case GAMMA_RAMP_SIZE_1024:
+        BuildRampNeon(ch, GAMMA_RAMP_SIZE_1024, params);
+        break;
+    case GAMMA_RAMP_SIZE_4096:
+        BuildRampNeon(ch, GAMMA_RAMP_SIZE_4096, params);
+        break;
+    default:
+        BuildRampNeon(ch, GAMMA_RAMP_SIZE, params);
+        break;
+    }
+}
+
+#endif /* NVCP_ARCH_ARM64 */
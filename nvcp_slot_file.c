@@ -0,0 +1,141 @@
+/*
+ * NVCP Toggle - Slot file
+ *
+ * File layout: a header followed by one fixed-size slot per display index.
+ * A slot's generation is odd while it is being rewritten and it carries a
+ * checksum, so a half-written slot reads as missing and the caller falls
+ * back to reading the display.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_backend.h"
+#include "nvcp_hash.h"
+#include "nvcp_slot_file.h"
+
+#define SLOT_FILE_BOOT_TOLERANCE 2  /* Seconds; boot time is derived from two clocks */
+
+struct SlotFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t payloadSize;
+    uint64_t key;           /* What the payloads refer to */
+    int64_t bootTime;       /* Boot the payloads describe, 0 = any */
+    uint64_t checksum;      /* Of the fields above */
+};
+
+/* Start of a slot; the payload and then its checksum follow */
+struct SlotHeader {
+    uint32_t generation;    /* Odd while being rewritten, 0 = empty */
+    uint32_t reserved;
+    char name[DISPLAY_NAME_SIZE];
+};
+
+static uint64_t HeaderChecksum(const struct SlotFileHeader* header) {
+    return HashBytes(FNV1A64_OFFSET, header, offsetof(struct SlotFileHeader, checksum));
+}
+
+static uint64_t SlotChecksum(const struct SlotHeader* slot, const void* payload, size_t payloadSize) {
+    uint64_t hash = HashBytes(FNV1A64_OFFSET, slot, sizeof(*slot));
+    return HashWords(hash, payload, payloadSize);
+}
+
+static struct SlotHeader* GetSlot(const SlotFile* file, int index) {
+    return (struct SlotHeader*)(file->slots + (size_t)index * file->slotSize);
+}
+
+static uint64_t* GetSlotChecksum(const SlotFile* file, struct SlotHeader* slot) {
+    return (uint64_t*)((unsigned char*)(slot + 1) + file->payloadSize);
+}
+
+/*
+ * Open (or create) a slot file
+ */
+bool OpenSlotFile(const char* path, const SlotFileFormat* format, SlotFile* file) {
+    memset(file, 0, sizeof(*file));
+    if (format->payloadSize % 8 != 0) return false;
+
+    file->slotCount = format->slotCount;
+    file->payloadSize = format->payloadSize;
+    file->slotSize = sizeof(struct SlotHeader) + format->payloadSize + sizeof(uint64_t);
+    size_t size = sizeof(struct SlotFileHeader) + format->slotCount * file->slotSize;
+    if (!MapFileWritable(path, size, &file->file)) {
+        return false;
+    }
+
+    file->header = (struct SlotFileHeader*)file->file.data;
+    file->slots = (unsigned char*)(file->header + 1);
+
+    struct SlotFileHeader* header = file->header;
+    int64_t bootTime = format->perBoot ? GetBootTime() : 0;
+    if (header->magic != format->magic || header->version != format->version ||
+        header->slotCount != format->slotCount || header->payloadSize != format->payloadSize ||
+        header->checksum != HeaderChecksum(header) || header->key != format->key ||
+        llabs(header->bootTime - bootTime) > SLOT_FILE_BOOT_TOLERANCE) {
+        /* New, stale or damaged file: nothing in it can be trusted */
+        memset(file->file.data, 0, size);
+        header->magic = format->magic;
+        header->version = format->version;
+        header->slotCount = format->slotCount;
+        header->payloadSize = format->payloadSize;
+        header->key = format->key;
+        header->bootTime = bootTime;
+        header->checksum = HeaderChecksum(header);
+    }
+
+    return true;
+}
+
+/*
+ * Unmap the file
+ */
+void CloseSlotFile(SlotFile* file) {
+    UnmapFile(&file->file);
+    file->header = NULL;
+    file->slots = NULL;
+}
+
+/*
+ * Copy out the payload of slot index; on a miss payload may be overwritten
+ */
+bool ReadSlot(const SlotFile* file, int index, const char* name, void* payload) {
+    if (!file->slots || index < 0 || (uint32_t)index >= file->slotCount) return false;
+
+    /* Checked against a copy, so a concurrent rewrite can't pass half-old, half-new */
+    struct SlotHeader* slot = GetSlot(file, index);
+    struct SlotHeader header = *slot;
+    if (header.generation == 0 || (header.generation & 1) || strncmp(header.name, name, sizeof(header.name)) != 0) {
+        return false;
+    }
+    memcpy(payload, slot + 1, file->payloadSize);
+    return *GetSlotChecksum(file, slot) == SlotChecksum(&header, payload, file->payloadSize);
+}
+
+/*
+ * Store the payload of slot index for the named display
+ */
+void WriteSlot(SlotFile* file, int index, const char* name, const void* payload) {
+    if (!file->slots || index < 0 || (uint32_t)index >= file->slotCount) return;
+
+    struct SlotHeader* slot = GetSlot(file, index);
+    uint32_t generation = (slot->generation | 1) + 1;  /* Next even value */
+
+    slot->generation = generation - 1;  /* Odd: being rewritten */
+    memset(slot->name, 0, sizeof(slot->name));
+    strncpy(slot->name, name, sizeof(slot->name) - 1);
+    memcpy(slot + 1, payload, file->payloadSize);
+    slot->generation = generation;
+    *GetSlotChecksum(file, slot) = SlotChecksum(slot, payload, file->payloadSize);
+}
+
+/*
+ * Mark slot index empty
+ */
+void ForgetSlot(SlotFile* file, int index) {
+    if (!file->slots || index < 0 || (uint32_t)index >= file->slotCount) return;
+    struct SlotHeader* slot = GetSlot(file, index);
+    slot->generation |= 1;
+    *GetSlotChecksum(file, slot) = 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * NVCP Toggle - Slot file
+ * Memory-mapped file of fixed-size per-display slots, each holding a display
+ * name and a payload. The state journal and the base ramp store are built
+ * on it.
+ */
+
+#ifndef NVCP_SLOT_FILE_H
+#define NVCP_SLOT_FILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nvcp_platform.h"
+
+/* What a slot file holds; a file written with anything else is reset */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t payloadSize;  /* Multiple of 8 */
+    uint64_t key;          /* Caller's identity of what the payloads refer to, 0 = none */
+    bool perBoot;          /* Payloads describe this boot only */
+} SlotFileFormat;
+
+typedef struct {
+    MappedFile file;
+    struct SlotFileHeader* header;
+    unsigned char* slots;
+    uint32_t slotCount;
+    uint32_t payloadSize;
+    size_t slotSize;
+} SlotFile;
+
+/*
+ * Open (or create) a slot file. A file of another format or key, a damaged
+ * header or, for a per-boot file, one written before the last boot is reset
+ * to empty slots.
+ */
+bool OpenSlotFile(const char* path, const SlotFileFormat* format, SlotFile* file);
+
+/*
+ * Unmap the file; slots are written through the mapping
+ */
+void CloseSlotFile(SlotFile* file);
+
+/*
+ * Copy out the payload of slot index, if it was written for a display of
+ * that name and is whole (not torn by a crash or a concurrent writer)
+ */
+bool ReadSlot(const SlotFile* file, int index, const char* name, void* payload);
+
+/*
+ * Store the payload of slot index for the named display
+ */
+void WriteSlot(SlotFile* file, int index, const char* name, const void* payload);
+
+/*
+ * Mark slot index empty
+ */
+void ForgetSlot(SlotFile* file, int index);
+
+#endif /* NVCP_SLOT_FILE_H */
@@ -0,0 +1,52 @@
+/*
+ * NVCP Toggle - Config parser checks
+ * Every key in the parser's table is reachable by name, and keys that only
+ * change a setting away from its default are actually applied.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "nvcp_config.h"
+
+static int failures;
+
+static void Check(bool ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static void Parse(Config* config, const char* text) {
+    SetDefaultConfig(config);
+    ParseConfigText(text, strlen(text), config);
+}
+
+int main(void) {
+    static Config config;  /* Large; keep it off the stack */
+
+    const char* misplaced = FindMisplacedConfigKey();
+    if (misplaced) printf("FAIL: config key %s is not in the slot its name hashes to\n", misplaced);
+    Check(misplaced == NULL, "key table slots");
+
+    Parse(&config, "stateJournal=true\n");
+    Check(config.stateJournal, "stateJournal=true");
+    Parse(&config, "composeRamps=true\n");
+    Check(config.composeRamps, "composeRamps=true");
+    Parse(&config, "compiledConfig=false\n");
+    Check(!config.compiledConfig, "compiledConfig=false");
+    Parse(&config, "syncDisplays=true\ngammaOnly=true\n");
+    Check(config.syncDisplays && config.gammaOnly, "syncDisplays, gammaOnly");
+    Parse(&config, "fadeDuration=250\nfadeEase=linear\n");
+    Check(config.fadeDuration == 250 && strcmp(config.fadeEase, "linear") == 0, "fadeDuration, fadeEase");
+    Parse(&config, "brightness=0.4\ncontrast=1.5\n");
+    Check(config.brightness == 0.4 && config.contrast == 1.5, "brightness, contrast past 1");
+    Parse(&config, "temperatureK=4500\n");
+    Check(config.temperature == 4500, "temperatureK");
+    Parse(&config, "cycleProfiles=true\n[profile.night]\nvibrance=55\n");
+    Check(config.cycleProfiles && config.profileCount == 1 && config.profiles[0].vibrance == 55, "profiles");
+
+    if (failures == 0) printf("config: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+/*
+ * NVCP Toggle - Profile index checks
+ * Every profile is found from its ramp as written and as a driver that
+ * rounds on readback returns it, and by its fingerprint; a ramp no profile
+ * has is not.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_profile.h"
+#include "nvcp_toggle.h"
+
+static int failures;
+
+static void Check(bool ok, const char* what, int profile) {
+    if (!ok) {
+        printf("FAIL: %s, profile %d\n", what, profile);
+        failures++;
+    }
+}
+
+/* Ramp as a driver that keeps 8 bits returns it */
+static void Truncate(const GammaRamp* in, GammaRamp* out) {
+    for (int c = 0; c < 3; c++) {
+        for (int i = 0; i < GAMMA_RAMP_SIZE; i++) {
+            out->ch[c][i] = in->ch[c][i] & 0xFF00;
+        }
+    }
+}
+
+/* Ramp with every entry moved by up to DEFAULT_RAMP_TOLERANCE either way */
+static void Jitter(const GammaRamp* in, GammaRamp* out) {
+    for (int c = 0; c < 3; c++) {
+        for (int i = 0; i < GAMMA_RAMP_SIZE; i++) {
+            int value = in->ch[c][i] + rand() % (2 * DEFAULT_RAMP_TOLERANCE + 1) - DEFAULT_RAMP_TOLERANCE;
+            out->ch[c][i] = (uint16_t)(value < 0 ? 0 : value > 65535 ? 65535 : value);
+        }
+    }
+}
+
+int main(void) {
+    static ProfileIndex index;  /* Large; keep it off the stack */
+    InitProfileIndex(&index);
+
+    /* Full index; the last two differ from the first only in vibrance and hue */
+    for (int i = 0; i < MAX_PROFILES; i++) {
+        Profile profile = { "", 50, 0, 0.5, 0.5, 0.6 + i * 0.1, 0 };
+        if (i == MAX_PROFILES - 2) profile = (Profile){ "", 80, 0, 0.5, 0.5, 0.6, 0 };
+        if (i == MAX_PROFILES - 1) profile = (Profile){ "", 50, 30, 0.5, 0.5, 0.6, 0 };
+        snprintf(profile.name, sizeof(profile.name), "p%d", i);
+        GammaRamp ramp;
+        BuildGammaRamp(&ramp, profile.brightness, profile.contrast, profile.gamma, profile.temperature);
+        Check(AddProfile(&index, &profile, &ramp), "added", i);
+    }
+
+    srand(1);
+    for (int i = 0; i < index.count; i++) {
+        const Profile* profile = &index.profiles[i];
+        int vibranceRaw = PercentToDVC(profile->vibrance, 63);
+        GammaRamp readback;
+
+        Check(FindProfile(&index, vibranceRaw, 63, profile->hue, &index.ramps[i]) == i, "exact ramp", i);
+        Truncate(&index.ramps[i], &readback);
+        Check(FindProfile(&index, vibranceRaw, 63, profile->hue, &readback) == i, "truncated ramp", i);
+        for (int trial = 0; trial < 100; trial++) {
+            Jitter(&index.ramps[i], &readback);
+            Check(FindProfile(&index, vibranceRaw, 63, profile->hue, &readback) == i, "jittered ramp", i);
+        }
+        /* Profiles that differ only in vibrance share a fingerprint: the first is found */
+        uint64_t fingerprint = GetProfileFingerprint(&index, i);
+        Check(FindProfileByFingerprint(&index, fingerprint) == (i == MAX_PROFILES - 2 ? 0 : i), "fingerprint", i);
+    }
+
+    /* Same ramp as profile 0 whatever the vibrance and hue: the first in file order */
+    GammaRamp readback;
+    Truncate(&index.ramps[MAX_PROFILES - 1], &readback);
+    Check(FindProfileRamp(&index, &readback) == 0, "ramp only", 0);
+
+    GammaRamp foreign;
+    BuildGammaRamp(&foreign, 0.3, 0.7, 1.0, 4000);
+    Check(FindProfile(&index, 0, 63, 0, &foreign) == PROFILE_UNKNOWN, "foreign ramp", PROFILE_UNKNOWN);
+    Check(FindProfileRamp(&index, &foreign) == PROFILE_UNKNOWN, "foreign ramp only", PROFILE_UNKNOWN);
+    Check(FindProfileByFingerprint(&index, 0) == PROFILE_UNKNOWN, "no fingerprint", PROFILE_UNKNOWN);
+
+    if (failures == 0) printf("profile: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+/*
+ * NVCP Toggle - Ramp kernel checks
+ * Every ramp kernel available on this CPU against BuildGammaRampReference on
+ * a dense grid of settings: no entry may be off by more than 1 LSB, and
+ * settings outside the kernels' range must come out as the reference. Then
+ * downsampled 1024/4096-entry ramps against directly built ones, within the
+ * bounds nvcp_ramp.h documents. Last, the ramp algebra: a ramp composed with
+ * its inverse is about the identity, blends end exactly on their inputs and
+ * scaling saturates.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nvcp_lut.h"
+#include "nvcp_ramp.h"
+
+#define KERNEL_MAX_LSB 1
+#define ROUND_TRIP_MAX_LSB       1   /* f(f^-1(y)) against y, gamma up to 1 */
+#define ROUND_TRIP_MAX_LSB_STEEP 32  /* Above: an eighth of an 8-bit step */
+
+/* Largest per-entry difference between two ramps */
+static int MaxDeviation(const GammaRamp* a, const GammaRamp* b) {
+    int worst = 0;
+    for (int c = 0; c < 3; c++) {
+        for (int i = 0; i < GAMMA_RAMP_SIZE; i++) {
+            int deviation = abs((int)a->ch[c][i] - (int)b->ch[c][i]);
+            if (deviation > worst) worst = deviation;
+        }
+    }
+    return worst;
+}
+
+/* Temperatures checked: the tint range and the Kelvin range */
+static int GetTestTemperature(int step) {
+    if (step <= 10) return -100 + step * 20;
+    return TEMPERATURE_MIN_KELVIN + (step - 11) * 700;
+}
+
+static int CheckKernels(void) {
+    static const char* kernels[] = { "fixed", "sse2", "avx2", "neon" };
+    const int kernelCount = (int)(sizeof(kernels) / sizeof(kernels[0]));
+    const int temperatureSteps = 11 + (TEMPERATURE_MAX_KELVIN - TEMPERATURE_MIN_KELVIN) / 700 + 1;
+    int worst[4] = {0};
+    bool available[4];
+    long ramps = 0;
+
+    for (int k = 0; k < kernelCount; k++) {
+        available[k] = SetGammaRampKernel(kernels[k]);
+    }
+
+    for (int b = 0; b <= 20; b++) {
+        for (int c = 0; c <= 20; c++) {
+            for (int g = 0; g <= 25; g++) {
+                for (int t = 0; t < temperatureSteps; t++) {
+                    double brightness = b * 0.05;
+                    double contrast = c * 0.05;
+                    double gamma = 0.5 + g * 0.1;
+                    int temperature = GetTestTemperature(t);
+
+                    GammaRamp reference;
+                    BuildGammaRampReference(&reference, brightness, contrast, gamma, temperature);
+                    for (int k = 0; k < kernelCount; k++) {
+                        if (!available[k]) continue;
+                        GammaRamp ramp;
+                        SetGammaRampKernel(kernels[k]);
+                        BuildGammaRamp(&ramp, brightness, contrast, gamma, temperature);
+                        int deviation = MaxDeviation(&ramp, &reference);
+                        if (deviation > worst[k]) {
+                            worst[k] = deviation;
+                            if (deviation > KERNEL_MAX_LSB) {
+                                printf("FAIL: %s off by %d at b=%.2f c=%.2f g=%.2f t=%d\n", kernels[k],
+                                       deviation, brightness, contrast, gamma, temperature);
+                            }
+                        }
+                    }
+                    ramps++;
+                }
+            }
+        }
+    }
+
+    /* Outside the range the fast kernels handle, every kernel must defer to the reference */
+    static const double outOfRange[][3] = { { 0.5, 1.5, 2.2 }, { 0.5, 8.0, 2.2 }, { -1.0, 0.5, 1.0 }, { 3.0, 4.0, 0.7 } };
+    int failures = 0;
+    for (int r = 0; r < (int)(sizeof(outOfRange) / sizeof(outOfRange[0])); r++) {
+        const double* setting = outOfRange[r];
+        GammaRamp reference;
+        BuildGammaRampReference(&reference, setting[0], setting[1], setting[2], 0);
+        for (int k = 0; k < kernelCount; k++) {
+            if (!available[k]) continue;
+            GammaRamp ramp;
+            SetGammaRampKernel(kernels[k]);
+            BuildGammaRamp(&ramp, setting[0], setting[1], setting[2], 0);
+            if (MaxDeviation(&ramp, &reference) != 0) {
+                printf("FAIL: %s differs from the reference at b=%.2f c=%.2f g=%.2f\n", kernels[k],
+                       setting[0], setting[1], setting[2]);
+                failures++;
+            }
+        }
+    }
+
+    for (int k = 0; k < kernelCount; k++) {
+        if (!available[k]) {
+            printf("%-6s not available on this CPU\n", kernels[k]);
+            continue;
+        }
+        printf("%-6s max deviation %d LSB over %ld ramps\n", kernels[k], worst[k], ramps);
+        if (worst[k] > KERNEL_MAX_LSB) failures++;
+    }
+    return failures;
+}
+
+/*
+ * Downsampled high-resolution ramps against the 256-entry ramp built
+ * directly, all with the reference engine so only resampling is measured
+ */
+static int CheckDownsampling(void) {
+    static const int temperatures[] = { -100, 0, 100, 3450 };
+    static GammaRamp1024 ramp1024;  /* Large; keep them off the stack */
+    static GammaRamp4096 ramp4096;
+    int worst1024 = 0, worst4096 = 0, steep1024 = 0, steep4096 = 0;
+
+    SetGammaRampKernel("reference");
+    for (int b = 0; b <= 10; b++) {
+        for (int c = 0; c <= 10; c++) {
+            for (int g = 0; g <= 25; g++) {
+                for (int t = 0; t < 4; t++) {
+                    double brightness = b * 0.1;
+                    double contrast = c * 0.1;
+                    double gamma = 0.5 + g * 0.1;
+                    GammaRamp direct, from1024, from4096;
+                    BuildGammaRamp(&direct, brightness, contrast, gamma, temperatures[t]);
+                    BuildGammaRamp1024(&ramp1024, brightness, contrast, gamma, temperatures[t]);
+                    BuildGammaRamp4096(&ramp4096, brightness, contrast, gamma, temperatures[t]);
+                    DownsampleGammaRamp1024(&ramp1024, &from1024);
+                    DownsampleGammaRamp4096(&ramp4096, &from4096);
+
+                    int deviation1024 = MaxDeviation(&from1024, &direct);
+                    int deviation4096 = MaxDeviation(&from4096, &direct);
+                    int* worst1024For = gamma <= 1.0 + 1e-9 ? &worst1024 : &steep1024;
+                    int* worst4096For = gamma <= 1.0 + 1e-9 ? &worst4096 : &steep4096;
+                    if (deviation1024 > *worst1024For) *worst1024For = deviation1024;
+                    if (deviation4096 > *worst4096For) *worst4096For = deviation4096;
+                }
+            }
+        }
+    }
+
+    printf("downsample 1024: max %d LSB up to gamma 1 (bound %d), %d above (bound %d)\n", worst1024,
+           DOWNSAMPLE_MAX_LSB_1024, steep1024, DOWNSAMPLE_MAX_LSB_1024_STEEP);
+    printf("downsample 4096: max %d LSB up to gamma 1 (bound %d), %d above (bound %d)\n", worst4096,
+           DOWNSAMPLE_MAX_LSB_4096, steep4096, DOWNSAMPLE_MAX_LSB_4096_STEEP);
+    return (worst1024 > DOWNSAMPLE_MAX_LSB_1024) + (steep1024 > DOWNSAMPLE_MAX_LSB_1024_STEEP) +
+           (worst4096 > DOWNSAMPLE_MAX_LSB_4096) + (steep4096 > DOWNSAMPLE_MAX_LSB_4096_STEEP);
+}
+
+/* Largest difference from the identity ramp, over outputs ramp reaches */
+static int IdentityDeviation(const GammaRamp* composed, const GammaRamp* ramp) {
+    int worst = 0;
+    for (int c = 0; c < 3; c++) {
+        for (int i = 0; i < GAMMA_RAMP_SIZE; i++) {
+            int identity = i * 257;
+            if (identity < ramp->ch[c][0] || identity > ramp->ch[c][GAMMA_RAMP_SIZE - 1]) continue;
+            int deviation = abs((int)composed->ch[c][i] - identity);
+            if (deviation > worst) worst = deviation;
+        }
+    }
+    return worst;
+}
+
+static int CheckRampAlgebra(void) {
+    static const int temperatures[] = { -100, 0, 100, 3450 };
+    int failures = 0;
+    int worst = 0, steep = 0;
+
+    SetGammaRampKernel("reference");
+    for (int b = 3; b <= 7; b++) {
+        for (int c = 3; c <= 7; c++) {
+            for (int g = 0; g <= 25; g++) {
+                for (int t = 0; t < 4; t++) {
+                    double gamma = 0.5 + g * 0.1;
+                    GammaRamp ramp, inverse, composed;
+                    BuildGammaRamp(&ramp, b * 0.1, c * 0.1, gamma, temperatures[t]);
+                    if (!InvertGammaRamp(&inverse, &ramp)) {
+                        printf("FAIL: ramp not invertible at b=%.1f c=%.1f g=%.2f t=%d\n", b * 0.1, c * 0.1, gamma,
+                               temperatures[t]);
+                        failures++;
+                        continue;
+                    }
+                    ComposeGammaRamps(&composed, &ramp, &inverse);
+                    int deviation = IdentityDeviation(&composed, &ramp);
+                    int* worstFor = gamma <= 1.0 + 1e-9 ? &worst : &steep;
+                    if (deviation > *worstFor) *worstFor = deviation;
+                }
+            }
+        }
+    }
+    printf("compose with inverse: max %d LSB up to gamma 1 (bound %d), %d above (bound %d)\n", worst,
+           ROUND_TRIP_MAX_LSB, steep, ROUND_TRIP_MAX_LSB_STEEP);
+    failures += (worst > ROUND_TRIP_MAX_LSB) + (steep > ROUND_TRIP_MAX_LSB_STEEP);
+
+    /* Blends end exactly on their inputs, also past the ends of the weight range */
+    GammaRamp a, b, blended;
+    BuildGammaRamp(&a, 0.4, 0.6, 2.2, 0);
+    BuildGammaRamp(&b, 0.6, 0.4, 0.8, 3450);
+    static const double weights[] = { 0.0, -0.5, 1.0, 1.5 };
+    for (int w = 0; w < 4; w++) {
+        BlendGammaRamps(&blended, &a, &b, weights[w]);
+        if (MaxDeviation(&blended, weights[w] <= 0.0 ? &a : &b) != 0) {
+            printf("FAIL: blend at weight %.1f is not exactly its input\n", weights[w]);
+            failures++;
+        }
+    }
+
+    /* Scaling saturates at both ends rather than wrapping */
+    static const double scales[][3] = { { 4.0, 4.0, 4.0 }, { 1.0, 1.0, 1.0 }, { -1.0, -1.0, -1.0 } };
+    static const double offsets[][3] = { { 0.0, 0.0, 0.0 }, { 2.0, -2.0, 0.5 }, { 0.0, 0.0, 0.0 } };
+    for (int s = 0; s < 3; s++) {
+        GammaRamp scaled;
+        ScaleGammaRamp(&scaled, &DefaultGammaRamp, scales[s], offsets[s]);
+        int deviation = 0;
+        for (int c = 0; c < 3; c++) {
+            for (int i = 0; i < GAMMA_RAMP_SIZE; i++) {
+                double expected = DefaultGammaRamp.ch[c][i] * scales[s][c] + offsets[s][c] * 65535.0;
+                int clamped = expected < 0.0 ? 0 : expected > 65535.0 ? 65535 : (int)(expected + 0.5);
+                int difference = abs((int)scaled.ch[c][i] - clamped);
+                if (difference > deviation) deviation = difference;
+            }
+        }
+        if (deviation > 1) {
+            printf("FAIL: scale %.1f offset %.1f off by %d from the clamped result\n", scales[s][0], offsets[s][0],
+                   deviation);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main(void) {
+    int failures = CheckKernels() + CheckDownsampling() + CheckRampAlgebra();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+/*
+ * NVCP Toggle - Threads and worker pool
+ */
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+#include <stdlib.h>
+
+#include "nvcp_thread.h"
+
+#define MAX_POOL_THREADS 64
+
+#ifdef _WIN32
+typedef SRWLOCK Mutex;
+typedef CONDITION_VARIABLE CondVar;
+typedef HANDLE Thread;
+#define MutexInit(m)        InitializeSRWLock(m)
+#define MutexDestroy(m)     ((void)(m))
+#define MutexLock(m)        AcquireSRWLockExclusive(m)
+#define MutexUnlock(m)      ReleaseSRWLockExclusive(m)
+#define CondInit(c)         InitializeConditionVariable(c)
+#define CondDestroy(c)      ((void)(c))
+#define CondWait(c, m)      SleepConditionVariableSRW(c, m, INFINITE, 0)
+#define CondBroadcast(c)    WakeAllConditionVariable(c)
+#else
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t CondVar;
+typedef pthread_t Thread;
+#define MutexInit(m)        pthread_mutex_init(m, NULL)
+#define MutexDestroy(m)     pthread_mutex_destroy(m)
+#define MutexLock(m)        pthread_mutex_lock(m)
+#define MutexUnlock(m)      pthread_mutex_unlock(m)
+#define CondInit(c)         pthread_cond_init(c, NULL)
+#define CondDestroy(c)      pthread_cond_destroy(c)
+#define CondWait(c, m)      pthread_cond_wait(c, m)
+#define CondBroadcast(c)    pthread_cond_broadcast(c)
+#endif
+
+struct WorkerPool {
+    Mutex lock;
+    CondVar workReady;
+    CondVar workDone;
+    Thread threads[MAX_POOL_THREADS];
+    int threadCount;     /* Worker threads, not counting the caller */
+    bool stopping;
+    unsigned generation; /* Bumped for every RunWorkerPool batch */
+
+    /* Current batch */
+    WorkerTask task;
+    void* arg;
+    int taskCount;
+    int nextTask;
+    int remaining;
+};
+
+/*
+ * Number of logical CPUs
+ */
+int GetCpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+/*
+ * OS identifier of the calling thread
+ */
+uint32_t GetCurrentThreadNumber(void) {
+#ifdef _WIN32
+    return (uint32_t)GetCurrentThreadId();
+#elif defined(__linux__)
+    return (uint32_t)syscall(SYS_gettid);
+#else
+    return (uint32_t)(uintptr_t)pthread_self();
+#endif
+}
+
+/* Take tasks from the current batch until none are left */
+static void RunPendingTasks(WorkerPool* pool) {
+    for (;;) {
+        MutexLock(&pool->lock);
+        if (pool->nextTask >= pool->taskCount) {
+            MutexUnlock(&pool->lock);
+            return;
+        }
+        int index = pool->nextTask++;
+        WorkerTask task = pool->task;
+        void* arg = pool->arg;
+        MutexUnlock(&pool->lock);
+
+        task(arg, index);
+
+        MutexLock(&pool->lock);
+        if (--pool->remaining == 0) {
+            CondBroadcast(&pool->workDone);
+        }
+        MutexUnlock(&pool->lock);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI WorkerMain(LPVOID param)
+#else
+static void* WorkerMain(void* param)
+#endif
+{
+    WorkerPool* pool = (WorkerPool*)param;
+    unsigned seen = 0;
+
+    MutexLock(&pool->lock);
+    for (;;) {
+        while (!pool->stopping && pool->generation == seen) {
+            CondWait(&pool->workReady, &pool->lock);
+        }
+        if (pool->stopping) break;
+        seen = pool->generation;
+        MutexUnlock(&pool->lock);
+
+        RunPendingTasks(pool);
+
+        MutexLock(&pool->lock);
+    }
+    MutexUnlock(&pool->lock);
+
+    return 0;
+}
+
+/*
+ * Start a pool that runs tasks on threadCount threads in total
+ */
+WorkerPool* CreateWorkerPool(int threadCount) {
+    WorkerPool* pool = (WorkerPool*)calloc(1, sizeof(WorkerPool));
+    if (!pool) return NULL;
+
+    MutexInit(&pool->lock);
+    CondInit(&pool->workReady);
+    CondInit(&pool->workDone);
+
+    int workers = threadCount - 1;
+    if (workers > MAX_POOL_THREADS) workers = MAX_POOL_THREADS;
+
+    for (int i = 0; i < workers; i++) {
+#ifdef _WIN32
+        HANDLE thread = CreateThread(NULL, 0, WorkerMain, pool, 0, NULL);
+        if (!thread) break;
+        pool->threads[i] = thread;
+#else
+        if (pthread_create(&pool->threads[i], NULL, WorkerMain, pool) != 0) break;
+#endif
+        pool->threadCount++;
+    }
+
+    return pool;
+}
+
+/*
+ * Run task(arg, 0..taskCount-1) across the pool and return once all are done
+ */
+void RunWorkerPool(WorkerPool* pool, int taskCount, WorkerTask task, void* arg) {
+    if (taskCount <= 0) return;
+
+    MutexLock(&pool->lock);
+    pool->task = task;
+    pool->arg = arg;
+    pool->taskCount = taskCount;
+    pool->nextTask = 0;
+    pool->remaining = taskCount;
+    pool->generation++;
+    CondBroadcast(&pool->workReady);
+    MutexUnlock(&pool->lock);
+
+    /* The caller works too, then waits for stragglers */
+    RunPendingTasks(pool);
+
+    MutexLock(&pool->lock);
+    while (pool->remaining > 0) {
+        CondWait(&pool->workDone, &pool->lock);
+    }
+    MutexUnlock(&pool->lock);
+}
+
+/*
+ * Total threads working on tasks, including the caller
+ */
+int GetWorkerPoolSize(const WorkerPool* pool) {
+    return pool->threadCount + 1;
+}
+
+/*
+ * Stop and join the workers
+ */
+void DestroyWorkerPool(WorkerPool* pool) {
+    if (!pool) return;
+
+    MutexLock(&pool->lock);
+    pool->stopping = true;
+    CondBroadcast(&pool->workReady);
+    MutexUnlock(&pool->lock);
+
+    for (int i = 0; i < pool->threadCount; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(pool->threads[i], INFINITE);
+        CloseHandle(pool->threads[i]);
+#else
+        pthread_join(pool->threads[i], NULL);
+#endif
+    }
+
+    CondDestroy(&pool->workDone);
+    CondDestroy(&pool->workReady);
+    MutexDestroy(&pool->lock);
+    free(pool);
+}
@@ -0,0 +1,48 @@
+/*
+ * NVCP Toggle - Threads and worker pool
+ * Win32 threads/SRW locks on Windows, pthreads elsewhere
+ */
+
+#ifndef NVCP_THREAD_H
+#define NVCP_THREAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Persistent set of worker threads; the calling thread also takes tasks */
+typedef struct WorkerPool WorkerPool;
+
+typedef void (*WorkerTask)(void* arg, int index);
+
+/*
+ * Number of logical CPUs
+ */
+int GetCpuCount(void);
+
+/*
+ * OS identifier of the calling thread
+ */
+uint32_t GetCurrentThreadNumber(void);
+
+/*
+ * Start a pool that runs tasks on threadCount threads in total (the caller
+ * plus threadCount - 1 workers). Returns NULL if threads can't be created.
+ */
+WorkerPool* CreateWorkerPool(int threadCount);
+
+/*
+ * Run task(arg, 0..taskCount-1) across the pool and return once all are done
+ */
+void RunWorkerPool(WorkerPool* pool, int taskCount, WorkerTask task, void* arg);
+
+/*
+ * Total threads working on tasks, including the caller
+ */
+int GetWorkerPoolSize(const WorkerPool* pool);
+
+/*
+ * Stop and join the workers
+ */
+void DestroyWorkerPool(WorkerPool* pool);
+
+#endif /* NVCP_THREAD_H */
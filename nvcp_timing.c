@@ -0,0 +1,117 @@
+/*
+ * NVCP Toggle - Phase timings
+ */
+
+#include "nvcp_atomic.h"
+#include "nvcp_timing.h"
+#include "nvcp_trace.h"
+
+typedef struct {
+    const char* name;
+    int depth;  /* Nesting under the phase listed above it */
+} PhaseInfo;
+
+static const PhaseInfo phaseInfo[PHASE_COUNT] = {
+    [PHASE_CONFIG_PATH]     = { "config_path", 0 },
+    [PHASE_LOAD_CONFIG]     = { "load_config", 0 },
+    [PHASE_BUILD_RAMPS]     = { "build_ramps", 0 },
+    [PHASE_INITIALIZE]      = { "initialize", 0 },
+    [PHASE_LOAD_EXTENSIONS] = { "load_extensions", 0 },
+    [PHASE_OPEN_DISPLAYS]   = { "open_displays", 0 },
+    [PHASE_ENUMERATE]       = { "enumerate", 1 },
+    [PHASE_CREATE_DC]       = { "create_dc", 1 },
+    [PHASE_TOGGLE]          = { "toggle", 0 },
+    [PHASE_READ_VIBRANCE]   = { "read_vibrance", 1 },
+    [PHASE_READ_HUE]        = { "read_hue", 1 },
+    [PHASE_READ_RAMP]       = { "read_ramp", 1 },
+    [PHASE_WRITE_VIBRANCE]  = { "write_vibrance", 1 },
+    [PHASE_WRITE_HUE]       = { "write_hue", 1 },
+    [PHASE_WRITE_RAMP]      = { "write_ramp", 1 },
+    [PHASE_CLOSE_DISPLAYS]  = { "close_displays", 0 },
+    [PHASE_UNLOAD]          = { "unload", 0 },
+};
+
+typedef struct {
+    volatile uint64_t calls;
+    volatile uint64_t totalNs;
+    volatile uint64_t maxNs;
+} PhaseStats;
+
+bool timingsEnabled = false;
+static bool statsEnabled = false;
+static bool traceEnabled = false;
+static uint64_t runStartNs;
+static PhaseStats phaseStats[PHASE_COUNT];
+
+/*
+ * Start collecting
+ */
+void EnableTimings(void) {
+    runStartNs = GetMonotonicNs();
+    statsEnabled = true;
+    timingsEnabled = true;
+}
+
+/*
+ * Also record every span as a trace event
+ */
+bool EnableTimingTrace(void) {
+    if (!EnableTrace(TRACE_DEFAULT_CAPACITY)) return false;
+    traceEnabled = true;
+    timingsEnabled = true;
+    return true;
+}
+
+/*
+ * Add one measured span to a phase
+ */
+void RecordTiming(TimingPhase phase, uint64_t startNs, const char* display) {
+    uint64_t endNs = GetMonotonicNs();
+
+    if (statsEnabled) {
+        uint64_t elapsed = endNs - startNs;
+        PhaseStats* stats = &phaseStats[phase];
+        AtomicAdd64(&stats->calls, 1);
+        AtomicAdd64(&stats->totalNs, elapsed);
+        AtomicMax64(&stats->maxNs, elapsed);
+    }
+    if (traceEnabled) {
+        TraceSpan(phaseInfo[phase].name, startNs, endNs, display);
+    }
+}
+
+/*
+ * Print every phase that ran
+ */
+void PrintTimings(FILE* out, TimingsFormat format) {
+    if (!statsEnabled) return;
+    uint64_t runNs = GetMonotonicNs() - runStartNs;
+
+    if (format == TIMINGS_JSON) {
+        fprintf(out, "{\"total_ns\":%llu,\"phases\":[", (unsigned long long)runNs);
+        bool first = true;
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            const PhaseStats* stats = &phaseStats[i];
+            if (!stats->calls) continue;
+            fprintf(out, "%s{\"name\":\"%s\",\"depth\":%d,\"calls\":%llu,\"total_ns\":%llu,\"max_ns\":%llu}",
+                    first ? "" : ",", phaseInfo[i].name, phaseInfo[i].depth,
+                    (unsigned long long)stats->calls, (unsigned long long)stats->totalNs,
+                    (unsigned long long)stats->maxNs);
+            first = false;
+        }
+        fprintf(out, "]}\n");
+        return;
+    }
+
+    fprintf(out, "\n%-20s %7s %12s %12s %12s %7s\n", "Phase", "Calls", "Total ms", "Avg us", "Max us", "Run %");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const PhaseStats* stats = &phaseStats[i];
+        if (!stats->calls) continue;
+        fprintf(out, "%*s%-*s %7llu %12.3f %12.1f %12.1f %6.1f%%\n",
+                phaseInfo[i].depth * 2, "", 20 - phaseInfo[i].depth * 2, phaseInfo[i].name,
+                (unsigned long long)stats->calls, (double)stats->totalNs / 1e6,
+                (double)stats->totalNs / (double)stats->calls / 1e3, (double)stats->maxNs / 1e3,
+                runNs ? 100.0 * (double)stats->totalNs / (double)runNs : 0.0);
+    }
+    fprintf(out, "%-20s %7s %12.3f\n", "total", "", (double)runNs / 1e6);
+}
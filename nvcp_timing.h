@@ -0,0 +1,74 @@
+/*
+ * NVCP Toggle - Phase timings
+ * Per-phase wall-clock totals for a run, reported with --timings, and
+ * the same spans as trace events with --trace.
+ * While both are off each TIMING_BEGIN/TIMING_END pair is one predictable branch.
+ */
+
+#ifndef NVCP_TIMING_H
+#define NVCP_TIMING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "nvcp_platform.h"
+
+typedef enum {
+    PHASE_CONFIG_PATH,
+    PHASE_LOAD_CONFIG,
+    PHASE_BUILD_RAMPS,
+    PHASE_INITIALIZE,
+    PHASE_LOAD_EXTENSIONS,
+    PHASE_OPEN_DISPLAYS,
+    PHASE_ENUMERATE,
+    PHASE_CREATE_DC,
+    PHASE_TOGGLE,
+    PHASE_READ_VIBRANCE,
+    PHASE_READ_HUE,
+    PHASE_READ_RAMP,
+    PHASE_WRITE_VIBRANCE,
+    PHASE_WRITE_HUE,
+    PHASE_WRITE_RAMP,
+    PHASE_CLOSE_DISPLAYS,
+    PHASE_UNLOAD,
+    PHASE_COUNT
+} TimingPhase;
+
+typedef enum {
+    TIMINGS_TABLE,
+    TIMINGS_JSON
+} TimingsFormat;
+
+extern bool timingsEnabled;  /* Phase totals or tracing is on */
+
+/*
+ * Start collecting phase totals; the run's total time counts from here
+ */
+void EnableTimings(void);
+
+/*
+ * Also record every span as a trace event (see nvcp_trace.h).
+ * Returns false if the trace ring can't be allocated.
+ */
+bool EnableTimingTrace(void);
+
+/*
+ * Add one measured span to a phase, tagged with the display it was for
+ * (NULL if none). Thread-safe.
+ */
+void RecordTiming(TimingPhase phase, uint64_t startNs, const char* display);
+
+/*
+ * Print every phase that ran, as an aligned table or a JSON object
+ */
+void PrintTimings(FILE* out, TimingsFormat format);
+
+/* Time a block: TIMING_BEGIN(t); ...; TIMING_END(PHASE_X, t); */
+#define TIMING_BEGIN(var) uint64_t var = timingsEnabled ? GetMonotonicNs() : 0
+#define TIMING_END(phase, var) \
+    do { if (var) RecordTiming(phase, var, NULL); } while (0)
+#define TIMING_END_DISPLAY(phase, var, display) \
+    do { if (var) RecordTiming(phase, var, display); } while (0)
+
+#endif /* NVCP_TIMING_H */
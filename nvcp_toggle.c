@@ -0,0 +1,556 @@
+/*
+ * NVCP Toggle - Toggle logic
+ * Decides between custom and default settings and applies them through a backend
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_lut.h"
+#include "nvcp_platform.h"
+#include "nvcp_timing.h"
+#include "nvcp_toggle.h"
+
+/*
+ * Convert NVCP percentage (50-100) to NVAPI DVC raw value (0-max)
+ * NVAPI range 0-63 maps to NVCP 50%-100%
+ * Formula: raw = (nvcp_pct - 50) * max / 50
+ */
+int PercentToDVC(int percent, int dvcMax) {
+    if (percent <= 50) return 0;
+    if (percent >= 100) return dvcMax;
+    return ((percent - 50) * dvcMax) / 50;
+}
+
+/*
+ * Convert NVAPI DVC raw value (0-max) to NVCP percentage (50-100)
+ * Formula: nvcp_pct = 50 + (raw * 50 / max)
+ */
+int DVCToPercent(int dvcValue, int dvcMax) {
+    if (dvcMax == 0) return 50;
+    return 50 + (dvcValue * 50) / dvcMax;
+}
+
+/*
+ * Get current digital vibrance level
+ */
+static int GetVibrance(const DisplayBackend* backend, const Display* display, int* outMin, int* outMax,
+                       bool* outValid) {
+    int level, minLevel, maxLevel;
+    *outValid = backend->GetDVCInfo(display, &level, &minLevel, &maxLevel);
+    if (!*outValid) {
+        return 0;  /* 0 = 50% in NVCP (default) */
+    }
+
+    if (outMin) *outMin = minLevel;
+    if (outMax) *outMax = maxLevel;
+
+    return level;
+}
+
+/*
+ * Get current HUE angle
+ */
+static int GetHue(const DisplayBackend* backend, const Display* display, bool* outValid) {
+    int angle;
+    *outValid = backend->GetHueInfo(display, &angle);
+    if (!*outValid) {
+        return DEFAULT_HUE;
+    }
+    return angle;
+}
+
+/*
+ * Check if the display's current gamma ramp matches base, or default (linear),
+ * within readback tolerance
+ */
+bool HasDefaultGammaRamp(const DisplayBackend* backend, const Display* display, const GammaRamp* base) {
+    GammaRamp currentRamp;
+
+    if (!backend->GetGammaRamp(display, &currentRamp)) {
+        return true; /* Assume default if we can't read */
+    }
+
+    return base ? GammaRampsMatch(&currentRamp, base, DEFAULT_RAMP_TOLERANCE) : IsDefaultGammaRamp(&currentRamp);
+}
+
+/*
+ * Ramp a journal profile number stands for, NULL if it is out of range
+ */
+static const GammaRamp* GetProfileRamp(const ProfileIndex* profiles, int profile) {
+    if (profile == PROFILE_DEFAULT) return &DefaultGammaRamp;
+    if (profile >= 0 && profile < profiles->count) return &profiles->ramps[profile];
+    return NULL;
+}
+
+/*
+ * Ramp a display should have on a profile: in compose mode the profile's ramp
+ * composed on the display's base (built in scratch), or the base itself for
+ * PROFILE_DEFAULT; otherwise the profile's own. NULL if out of range.
+ */
+static const GammaRamp* GetTargetRamp(const ToggleContext* ctx, const DisplayState* state, int profile,
+                                      GammaRamp* scratch) {
+    const GammaRamp* ramp = GetProfileRamp(ctx->profiles, profile);
+    if (!ramp || !state->hasBase) return ramp;
+    if (profile == PROFILE_DEFAULT) return &state->base.ramp;
+
+    /* Calibration outermost: it corrects the display, whatever the profile feeds it */
+    ComposeGammaRamps(scratch, &state->base.ramp, ramp);
+    return scratch;
+}
+
+/*
+ * Compose mode: find which of this tool's ramps the one read back is, on the
+ * display's base, allowing for the driver rounding on readback as
+ * IsDefaultGammaRamp does. Only the base and the profile last composed on
+ * it are candidates. A ramp this tool did not write was set by another tool
+ * (a calibration loader, a night-light tool) and becomes the new base.
+ */
+static void MatchBaseRamp(const ToggleContext* ctx, const Display* display, DisplayState* state) {
+    if (state->hasBase) {
+        if (GammaRampsMatch(&state->ramp, &state->base.ramp, DEFAULT_RAMP_TOLERANCE)) {
+            state->rampProfile = PROFILE_DEFAULT;
+            return;
+        }
+        /* By fingerprint, so a config change that renumbers profiles still finds it */
+        int applied = FindProfileByFingerprint(ctx->profiles, state->base.applied);
+        GammaRamp composed;
+        if (applied >= 0 &&
+            GammaRampsMatch(&state->ramp, GetTargetRamp(ctx, state, applied, &composed), DEFAULT_RAMP_TOLERANCE)) {
+            state->rampProfile = applied;
+            return;
+        }
+    }
+
+    /* A profile's own ramp was written without compose mode, over a linear one */
+    int profile = FindProfileRamp(ctx->profiles, &state->ramp);
+    state->base.ramp = profile >= 0 ? DefaultGammaRamp : state->ramp;
+    state->base.applied = GetProfileFingerprint(ctx->profiles, profile);
+    state->rampProfile = profile >= 0 ? profile : PROFILE_DEFAULT;
+    state->hasBase = true;
+    state->baseCaptured = true;
+    WriteBaseRamp(ctx->baseRamps, display->index, display->name, &state->base);
+}
+
+/*
+ * Take a display's state from the journal, if its entry is intact and a
+ * DVC read agrees with it
+ */
+static bool ReadJournaledState(const ToggleContext* ctx, const Display* display, DisplayState* state) {
+    JournalState entry;
+    if (!ReadJournalEntry(ctx->journal, display->index, display->name, &entry)) return false;
+
+    GammaRamp composed;
+    const GammaRamp* ramp = GetTargetRamp(ctx, state, entry.profile, &composed);
+    if (!ramp || JournalRampFingerprint(ramp) != entry.rampFingerprint) return false;
+
+    /* The one cheap read: vibrance changed elsewhere means nothing else can be trusted either */
+    int level, minLevel, maxLevel;
+    TIMING_BEGIN(vibranceStart);
+    bool read = ctx->backend->GetDVCInfo(display, &level, &minLevel, &maxLevel);
+    TIMING_END_DISPLAY(PHASE_READ_VIBRANCE, vibranceStart, display->name);
+    if (!read || level != entry.vibranceRaw || maxLevel != entry.dvcMax) return false;
+
+    state->vibranceRaw = entry.vibranceRaw;
+    state->dvcMin = entry.dvcMin;
+    state->dvcMax = entry.dvcMax;
+    state->hue = entry.hue;
+    state->ramp = *ramp;
+    state->vibranceRead = state->hueRead = true;
+    state->rampRead = true;
+    state->rampProfile = entry.profile;
+    state->isDefault = (entry.profile == PROFILE_DEFAULT);
+    state->fromJournal = true;
+    return true;
+}
+
+/*
+ * Read a display's vibrance, hue and gamma ramp
+ */
+void ReadDisplayState(const ToggleContext* ctx, const Display* display, DisplayState* state) {
+    const DisplayBackend* backend = ctx->backend;
+    state->baseCaptured = false;
+    state->rampProfile = PROFILE_UNKNOWN;
+    state->hasBase = ctx->baseRamps && ReadBaseRamp(ctx->baseRamps, display->index, display->name, &state->base);
+
+    /* Gamma-only runs read nothing the journal could be confirmed by but the ramp itself, and
+       compose mode must read the ramp to see one another tool set since the last toggle */
+    if (ctx->journal && !ctx->gammaOnly && !ctx->baseRamps && ReadJournaledState(ctx, display, state)) {
+        return;
+    }
+
+    state->fromJournal = false;
+    state->dvcMin = 0;
+    state->dvcMax = 63;  /* Default max if query fails */
+    if (ctx->gammaOnly) {
+        state->vibranceRaw = PercentToDVC(DEFAULT_VIBRANCE_PCT, state->dvcMax);
+        state->vibranceRead = false;
+        state->hue = DEFAULT_HUE;
+        state->hueRead = false;
+    } else {
+        TIMING_BEGIN(vibranceStart);
+        state->vibranceRaw = GetVibrance(backend, display, &state->dvcMin, &state->dvcMax, &state->vibranceRead);
+        TIMING_END_DISPLAY(PHASE_READ_VIBRANCE, vibranceStart, display->name);
+        if (!state->vibranceRead) {
+            /* A range seen on an earlier run still makes writes land right */
+            backend->GetDVCRange(display, &state->dvcMin, &state->dvcMax);
+        }
+        TIMING_BEGIN(hueStart);
+        state->hue = GetHue(backend, display, &state->hueRead);
+        TIMING_END_DISPLAY(PHASE_READ_HUE, hueStart, display->name);
+    }
+    TIMING_BEGIN(rampStart);
+    state->rampRead = backend->GetGammaRamp(display, &state->ramp);
+    TIMING_END_DISPLAY(PHASE_READ_RAMP, rampStart, display->name);
+    if (ctx->baseRamps && state->rampRead) MatchBaseRamp(ctx, display, state);
+
+    /* Check if at default state (within small tolerance for rounding) */
+    int defaultVibranceRaw = PercentToDVC(DEFAULT_VIBRANCE_PCT, state->dvcMax);
+    bool defaultRamp = !state->rampRead ||  /* Assume default if we can't read */
+                       (ctx->baseRamps ? state->rampProfile == PROFILE_DEFAULT : IsDefaultGammaRamp(&state->ramp));
+    state->isDefault = (abs(state->vibranceRaw - defaultVibranceRaw) <= 1 &&
+                        state->hue == DEFAULT_HUE && defaultRamp);
+}
+
+/*
+ * Work out the driver writes that move a display from its current state to
+ * the target; a field that already has the target value is left alone
+ */
+void PlanDisplaySettings(const ToggleContext* ctx, const DisplayState* state, int target, ApplyPlan* plan,
+                         GammaRamp* scratch) {
+    bool isProfile = target >= 0;
+    const Profile* profile = isProfile ? &ctx->profiles->profiles[target] : NULL;
+    int targetVibranceRaw = PercentToDVC(isProfile ? profile->vibrance : DEFAULT_VIBRANCE_PCT, state->dvcMax);
+    int targetHue = isProfile ? profile->hue : DEFAULT_HUE;
+    const GammaRamp* targetRamp = GetTargetRamp(ctx, state, target, scratch);
+
+    plan->vibranceRaw = targetVibranceRaw;
+    plan->setVibrance = !ctx->gammaOnly && (!state->vibranceRead || state->vibranceRaw != targetVibranceRaw);
+    plan->hue = targetHue;
+    plan->setHue = !ctx->gammaOnly && (!state->hueRead || state->hue != targetHue);
+    plan->ramp = (state->rampRead && GammaRampsMatch(&state->ramp, targetRamp, 0)) ? NULL : targetRamp;
+}
+
+/*
+ * Issue the writes in a plan, counting the ones it skips
+ */
+bool ExecuteApplyPlan(const DisplayBackend* backend, const Display* display, const ApplyPlan* plan,
+                      WriteCounters* counters) {
+    bool ok = true;
+
+    if (plan->setVibrance) {
+        TIMING_BEGIN(vibranceStart);
+        ok = backend->SetDVCLevel(display, plan->vibranceRaw) && ok;
+        TIMING_END_DISPLAY(PHASE_WRITE_VIBRANCE, vibranceStart, display->name);
+        counters->vibranceWrites++;
+    } else {
+        counters->vibranceElided++;
+    }
+
+    if (plan->setHue) {
+        TIMING_BEGIN(hueStart);
+        ok = backend->SetHueAngle(display, plan->hue) && ok;
+        TIMING_END_DISPLAY(PHASE_WRITE_HUE, hueStart, display->name);
+        counters->hueWrites++;
+    } else {
+        counters->hueElided++;
+    }
+
+    if (plan->ramp) {
+        TIMING_BEGIN(rampStart);
+        ok = backend->SetGammaRamp(display, plan->ramp) && ok;
+        TIMING_END_DISPLAY(PHASE_WRITE_RAMP, rampStart, display->name);
+        counters->rampWrites++;
+    } else {
+        counters->rampElided++;
+    }
+    return ok;
+}
+
+/*
+ * Issue a plan's writes as a fade from the display's current state
+ */
+bool ExecuteFade(const ToggleContext* ctx, const Display* display, const DisplayState* state,
+                 const ApplyPlan* plan, FadePlan* fade, WriteCounters* counters) {
+    FadeEndpoint from = { state->vibranceRead, state->vibranceRaw, state->hueRead, state->hue,
+                          state->rampRead ? &state->ramp : NULL };
+    FadeEndpoint to = { plan->setVibrance, plan->vibranceRaw, plan->setHue, plan->hue, plan->ramp };
+    BuildFadePlan(fade, &from, &to, ctx->fades->durationNs, ctx->fades->curve);
+
+    /* Intermediate frames count as writes; elided ones are counted once, as without a fade */
+    WriteCounters frameCounters = {0};
+    bool ok = true;
+    uint64_t start = GetMonotonicNs();
+    for (int i = 0; i < fade->count; i++) {
+        const FadeFrame* frame = &fade->frames[i];
+        ApplyPlan step = { frame->setVibrance, frame->vibranceRaw, frame->setHue, frame->hue,
+                           frame->setRamp ? &fade->ramps[i] : NULL };
+        SleepUntilNs(start + frame->atNs);
+        ok = ExecuteApplyPlan(ctx->backend, display, &step, &frameCounters) && ok;
+    }
+
+    counters->vibranceWrites += frameCounters.vibranceWrites;
+    counters->hueWrites += frameCounters.hueWrites;
+    counters->rampWrites += frameCounters.rampWrites;
+    if (!plan->setVibrance) counters->vibranceElided++;
+    if (!plan->setHue) counters->hueElided++;
+    if (!plan->ramp) counters->rampElided++;
+    return ok;
+}
+
+/*
+ * Add one set of write counters to another
+ */
+void AddWriteCounters(WriteCounters* total, const WriteCounters* counters) {
+    total->vibranceWrites += counters->vibranceWrites;
+    total->vibranceElided += counters->vibranceElided;
+    total->hueWrites += counters->hueWrites;
+    total->hueElided += counters->hueElided;
+    total->rampWrites += counters->rampWrites;
+    total->rampElided += counters->rampElided;
+}
+
+/*
+ * Print how many driver writes were issued and skipped
+ */
+static void PrintWriteCounters(Output* out, const WriteCounters* counters) {
+    int writes = counters->vibranceWrites + counters->hueWrites + counters->rampWrites;
+    int elided = counters->vibranceElided + counters->hueElided + counters->rampElided;
+    OutputPrintf(out, "Driver writes: %d issued, %d elided (vibrance %d, hue %d, gamma ramp %d)\n",
+                 writes, elided, counters->vibranceElided, counters->hueElided, counters->rampElided);
+}
+
+/*
+ * Profile a display is on, from the settings read back
+ */
+int IdentifyProfile(const ProfileIndex* profiles, const DisplayState* state) {
+    if (state->isDefault) return PROFILE_DEFAULT;
+    if (!state->rampRead) return PROFILE_UNKNOWN;
+
+    /* Compose mode: the ramp read back has the base in it, so match by the profile's own */
+    const GammaRamp* ramp = state->hasBase ? GetProfileRamp(profiles, state->rampProfile) : &state->ramp;
+    if (!ramp) return PROFILE_UNKNOWN;
+    return FindProfile(profiles, state->vibranceRaw, state->dvcMax, state->hue, ramp);
+}
+
+/*
+ * Apply a profile or the defaults to a display
+ */
+void ApplyDisplaySettings(const ToggleContext* ctx, const Display* display, const DisplayState* state,
+                          int target, Output* out, WriteCounters* counters) {
+    OutputPrintf(out, "Display: %s\n", display->name);
+    if (state->baseCaptured) {
+        OutputPrintf(out, "Captured the display's existing gamma ramp to compose on\n");
+    }
+
+    if (target >= 0) {
+        /* Toggle ON - apply custom settings */
+        const Profile* profile = &ctx->profiles->profiles[target];
+        if (profile->name[0]) {
+            OutputPrintf(out, "Switching to profile %s (%d of %d):\n", profile->name, target + 1,
+                         ctx->profiles->count);
+        } else {
+            OutputPrintf(out, "Toggling Custom Settings:\n");
+        }
+        OutputPrintf(out, "Vibrance: %d%%  Hue: %d  Temp: %d%s\n", profile->vibrance, profile->hue,
+                     profile->temperature, profile->temperature >= TEMPERATURE_MIN_KELVIN ? "K" : "");
+        OutputPrintf(out, "Brightness: %.2f  Contrast: %.2f  Gamma: %.2f\n",
+                     profile->brightness, profile->contrast, profile->gamma);
+    } else {
+        /* Toggle OFF - reset to defaults */
+        OutputPrintf(out, "Resetting to default settings...\n");
+    }
+
+    ApplyPlan plan;
+    GammaRamp composed;
+    PlanDisplaySettings(ctx, state, target, &plan, &composed);
+    bool applied;
+    bool changes = plan.setVibrance || plan.setHue || plan.ramp;
+    if (ctx->fades && changes && display->index >= 0 && display->index < FADE_MAX_DISPLAYS) {
+        FadePlan* fade = &ctx->fades->plans[display->index];
+        applied = ExecuteFade(ctx, display, state, &plan, fade, counters);
+        OutputPrintf(out, "Faded over %.0f ms: %d frame(s) written, %d unchanged skipped\n",
+                     (double)ctx->fades->durationNs / 1e6, fade->count, fade->skipped);
+    } else {
+        applied = ExecuteApplyPlan(ctx->backend, display, &plan, counters);
+    }
+
+    if (ctx->baseRamps && state->hasBase && applied) {
+        /* The next read then has one composed ramp to compare against, not every profile's */
+        uint64_t fingerprint = GetProfileFingerprint(ctx->profiles, target);
+        if (fingerprint != state->base.applied) {
+            BaseRamp base = state->base;
+            base.applied = fingerprint;
+            WriteBaseRamp(ctx->baseRamps, display->index, display->name, &base);
+        }
+    }
+
+    if (ctx->journal) {
+        if (applied) {
+            const GammaRamp* ramp = GetTargetRamp(ctx, state, target, &composed);
+            JournalState entry = { target, plan.vibranceRaw, state->dvcMin, state->dvcMax, plan.hue,
+                                   JournalRampFingerprint(ramp) };
+            WriteJournalEntry(ctx->journal, display->index, display->name, &entry);
+        } else {
+            ForgetJournalEntry(ctx->journal, display->index);
+        }
+    }
+}
+
+/*
+ * Toggle display settings for a single display
+ */
+void ToggleDisplay(const ToggleContext* ctx, const Display* display, Output* out, WriteCounters* counters) {
+    DisplayState state;
+    ReadDisplayState(ctx, display, &state);
+    int target = NextProfile(ctx->profiles, IdentifyProfile(ctx->profiles, &state));
+    ApplyDisplaySettings(ctx, display, &state, target, out, counters);
+}
+
+/*
+ * Open the primary display or all displays
+ */
+void OpenDisplaySet(const DisplayBackend* backend, bool allDisplays, DisplaySet* set) {
+    set->count = 0;
+    set->allDisplays = allDisplays;
+
+    if (allDisplays) {
+        /* Enumerate all NVIDIA displays */
+        while (set->count < MAX_DISPLAYS && backend->OpenDisplay(set->count, &set->displays[set->count])) {
+            set->count++;
+        }
+    } else if (backend->OpenPrimaryDisplay(&set->displays[0])) {
+        set->count = 1;
+    }
+}
+
+/*
+ * Release every display in the set
+ */
+void CloseDisplaySet(const DisplayBackend* backend, DisplaySet* set) {
+    for (int i = 0; i < set->count; i++) {
+        backend->CloseDisplay(&set->displays[i]);
+    }
+    set->count = 0;
+}
+
+/*
+ * Worker threads to use for a display set
+ */
+int GetToggleWorkerCount(const Config* config, const DisplaySet* set) {
+    int workers = config->workers > 0 ? config->workers : set->count;
+    if (workers > set->count) workers = set->count;
+    return workers > 0 ? workers : 1;
+}
+
+/* Per-display state and results of a multi-display toggle, printed in display order afterwards */
+typedef struct {
+    const ToggleContext* ctx;
+    const DisplaySet* set;
+    int target;     /* Global decision for a synchronized toggle */
+    DisplayState states[MAX_DISPLAYS];
+    WriteCounters counters[MAX_DISPLAYS];
+    Output outputs[MAX_DISPLAYS];
+    uint64_t elapsedNs[MAX_DISPLAYS];
+} MultiDisplayToggle;
+
+static void ToggleDisplayTask(void* arg, int index) {
+    MultiDisplayToggle* job = (MultiDisplayToggle*)arg;
+    uint64_t start = GetMonotonicNs();
+    ToggleDisplay(job->ctx, &job->set->displays[index], &job->outputs[index], &job->counters[index]);
+    job->elapsedNs[index] = GetMonotonicNs() - start;
+}
+
+static void ReadDisplayTask(void* arg, int index) {
+    MultiDisplayToggle* job = (MultiDisplayToggle*)arg;
+    uint64_t start = GetMonotonicNs();
+    ReadDisplayState(job->ctx, &job->set->displays[index], &job->states[index]);
+    job->elapsedNs[index] = GetMonotonicNs() - start;
+}
+
+static void ApplyDisplayTask(void* arg, int index) {
+    MultiDisplayToggle* job = (MultiDisplayToggle*)arg;
+    uint64_t start = GetMonotonicNs();
+    ApplyDisplaySettings(job->ctx, &job->set->displays[index], &job->states[index], job->target,
+                         &job->outputs[index], &job->counters[index]);
+    job->elapsedNs[index] += GetMonotonicNs() - start;
+}
+
+/* Run a task for every display, on the pool if there is one */
+static void RunForEachDisplay(const ToggleContext* ctx, int count, WorkerTask task, MultiDisplayToggle* job) {
+    if (ctx->workers) {
+        RunWorkerPool(ctx->workers, count, task, job);
+    } else {
+        for (int i = 0; i < count; i++) {
+            task(job, i);
+        }
+    }
+}
+
+/*
+ * Toggle every display in the set, concurrently when ctx->workers is set
+ */
+void ToggleDisplays(const ToggleContext* ctx, const DisplaySet* set, Output* out) {
+    WriteCounters total = {0};
+
+    if (!set->allDisplays) {
+        OutputPrintf(out, "Toggling primary display...\n\n");
+        for (int i = 0; i < set->count; i++) {
+            ToggleDisplay(ctx, &set->displays[i], out, &total);
+        }
+        PrintWriteCounters(out, &total);
+        return;
+    }
+
+    OutputPrintf(out, "Toggling all displays...\n\n");
+
+    static MultiDisplayToggle job;  /* Large; runs never overlap */
+    job.ctx = ctx;
+    job.set = set;
+    for (int i = 0; i < set->count; i++) {
+        OutputInit(&job.outputs[i]);
+        memset(&job.counters[i], 0, sizeof(job.counters[i]));
+    }
+
+    /* Each display buffers its own output so the report stays in display order */
+    uint64_t start = GetMonotonicNs();
+    uint64_t readNs = 0;
+    if (ctx->config->syncDisplays && set->count > 0) {
+        /* Phase one: read every display; phase two: apply one decision to all */
+        RunForEachDisplay(ctx, set->count, ReadDisplayTask, &job);
+        readNs = GetMonotonicNs() - start;
+
+        /* Move on only if every display is on the same profile, else reset them all */
+        int current = IdentifyProfile(ctx->profiles, &job.states[0]);
+        bool inSync = true;
+        for (int i = 1; i < set->count && inSync; i++) {
+            inSync = IdentifyProfile(ctx->profiles, &job.states[i]) == current;
+        }
+        if (inSync) {
+            job.target = NextProfile(ctx->profiles, current);
+        } else {
+            job.target = PROFILE_DEFAULT;
+            OutputPrintf(out, "Displays out of sync, resetting all\n\n");
+        }
+
+        RunForEachDisplay(ctx, set->count, ApplyDisplayTask, &job);
+    } else {
+        RunForEachDisplay(ctx, set->count, ToggleDisplayTask, &job);
+    }
+    uint64_t totalNs = GetMonotonicNs() - start;
+
+    for (int i = 0; i < set->count; i++) {
+        OutputAppend(out, &job.outputs[i]);
+        OutputPrintf(out, "Display time: %.2f ms\n\n", (double)job.elapsedNs[i] / 1e6);
+        OutputFree(&job.outputs[i]);
+        AddWriteCounters(&total, &job.counters[i]);
+    }
+    OutputPrintf(out, "Toggled %d display(s) in %.2f ms using %d worker(s)",
+                 set->count, (double)totalNs / 1e6, ctx->workers ? GetWorkerPoolSize(ctx->workers) : 1);
+    if (ctx->config->syncDisplays && set->count > 0) {
+        OutputPrintf(out, " (read %.2f ms, apply %.2f ms)",
+                     (double)readNs / 1e6, (double)(totalNs - readNs) / 1e6);
+    }
+    OutputPrintf(out, "\n");
+    PrintWriteCounters(out, &total);
+}
@@ -0,0 +1,180 @@
+/*
+ * NVCP Toggle - Toggle logic
+ */
+
+#ifndef NVCP_TOGGLE_H
+#define NVCP_TOGGLE_H
+
+#include <stdbool.h>
+
+#include "nvcp_backend.h"
+#include "nvcp_base_ramp.h"
+#include "nvcp_config.h"
+#include "nvcp_fade.h"
+#include "nvcp_journal.h"
+#include "nvcp_output.h"
+#include "nvcp_profile.h"
+#include "nvcp_ramp.h"
+#include "nvcp_thread.h"
+
+#define MAX_DISPLAYS 32
+
+/*
+ * Convert NVCP percentage (50-100) to NVAPI DVC raw value (0-max)
+ */
+int PercentToDVC(int percent, int dvcMax);
+
+/*
+ * Convert NVAPI DVC raw value (0-max) to NVCP percentage (50-100)
+ */
+int DVCToPercent(int dvcValue, int dvcMax);
+
+/*
+ * Check if the display's current gamma ramp matches base, or default
+ * (linear) when base is NULL, within DEFAULT_RAMP_TOLERANCE
+ */
+bool HasDefaultGammaRamp(const DisplayBackend* backend, const Display* display, const GammaRamp* base);
+
+/* Everything a toggle run shares across displays */
+typedef struct {
+    const DisplayBackend* backend;
+    const Config* config;
+    const ProfileIndex* profiles; /* What a toggle moves between, with their ramps */
+    WorkerPool* workers;          /* Toggles displays concurrently, NULL = serial */
+    bool gammaOnly;               /* Vibrance and hue are neither read nor written */
+    StateJournal* journal;        /* Last applied state per display, NULL, gammaOnly or baseRamps = always read back */
+    FadeArena* fades;             /* Fade transitions, NULL = switch instantly */
+    BaseRampStore* baseRamps;     /* Compose profiles on each display's own ramp, NULL = absolute ramps */
+} ToggleContext;
+
+/* What a display currently has applied, read before deciding */
+typedef struct {
+    int vibranceRaw;
+    int dvcMin;
+    int dvcMax;
+    int hue;
+    bool vibranceRead; /* Driver reads that succeeded */
+    bool hueRead;
+    bool rampRead;
+    GammaRamp ramp;
+    bool isDefault;    /* Vibrance, hue and ramp all at defaults */
+    bool fromJournal;  /* Taken from the journal rather than read back */
+    bool hasBase;      /* Compose mode: base is the display's own ramp, its default */
+    bool baseCaptured; /* Compose mode: base was taken from this read */
+    int rampProfile;   /* Compose mode: profile whose ramp composed on base is ramp,
+                          PROFILE_DEFAULT for base itself, else PROFILE_UNKNOWN */
+    BaseRamp base;
+} DisplayState;
+
+/* Driver writes needed to reach a target state; unset fields already match */
+typedef struct {
+    bool setVibrance;
+    int vibranceRaw;
+    bool setHue;
+    int hue;
+    const GammaRamp* ramp;  /* NULL = already applied */
+} ApplyPlan;
+
+/* Driver writes issued and skipped because the value was already set */
+typedef struct {
+    int vibranceWrites;
+    int vibranceElided;
+    int hueWrites;
+    int hueElided;
+    int rampWrites;
+    int rampElided;
+} WriteCounters;
+
+/* Displays opened for a run: the primary one, or every NVIDIA display */
+typedef struct {
+    Display displays[MAX_DISPLAYS];
+    int count;
+    bool allDisplays;
+} DisplaySet;
+
+/*
+ * Open the primary display or all displays; handles stay valid until
+ * CloseDisplaySet, so a resident process can reuse them
+ */
+void OpenDisplaySet(const DisplayBackend* backend, bool allDisplays, DisplaySet* set);
+
+/*
+ * Release every display in the set
+ */
+void CloseDisplaySet(const DisplayBackend* backend, DisplaySet* set);
+
+/*
+ * Read a display's vibrance, hue and gamma ramp; with ctx->gammaOnly only
+ * the ramp, with vibrance and hue taken to be at defaults. With a journal,
+ * the state last applied is used instead when its entry is intact and one
+ * DVC read agrees with it; with gammaOnly there is no such read, so the
+ * journal is not used. With ctx->baseRamps the ramp is always read back,
+ * and one this tool did not write becomes the display's base.
+ */
+void ReadDisplayState(const ToggleContext* ctx, const Display* display, DisplayState* state);
+
+/*
+ * Profile a display is on (an index into ctx->profiles, PROFILE_DEFAULT or
+ * PROFILE_UNKNOWN), from the settings read back
+ */
+int IdentifyProfile(const ProfileIndex* profiles, const DisplayState* state);
+
+/*
+ * Work out the driver writes that move a display from its current state to
+ * profile target or, for PROFILE_DEFAULT, the defaults; fields that were
+ * read back with the target value already are skipped. In compose mode the
+ * target ramp is the profile's composed on the display's base, built in
+ * scratch, which plan->ramp may then point to.
+ */
+void PlanDisplaySettings(const ToggleContext* ctx, const DisplayState* state, int target, ApplyPlan* plan,
+                         GammaRamp* scratch);
+
+/*
+ * Issue the writes in a plan, counting issued and skipped ones. Returns
+ * false if a write failed.
+ */
+bool ExecuteApplyPlan(const DisplayBackend* backend, const Display* display, const ApplyPlan* plan,
+                      WriteCounters* counters);
+
+/*
+ * Add one set of write counters to another
+ */
+void AddWriteCounters(WriteCounters* total, const WriteCounters* counters);
+
+/*
+ * Issue a plan's writes as a fade from the display's current state, one
+ * frame per refresh over ctx->fades->durationNs, with the last frame writing
+ * exactly what the plan does. Blocks until the fade ends. Returns false if
+ * a write failed.
+ */
+bool ExecuteFade(const ToggleContext* ctx, const Display* display, const DisplayState* state,
+                 const ApplyPlan* plan, FadePlan* fade, WriteCounters* counters);
+
+/*
+ * Apply profile target or, for PROFILE_DEFAULT, the defaults to a display,
+ * fading when ctx->fades is set
+ */
+void ApplyDisplaySettings(const ToggleContext* ctx, const Display* display, const DisplayState* state,
+                          int target, Output* out, WriteCounters* counters);
+
+/*
+ * Toggle display settings for a single display: move it to the profile
+ * after the one it is on
+ */
+void ToggleDisplay(const ToggleContext* ctx, const Display* display, Output* out, WriteCounters* counters);
+
+/*
+ * Worker threads to use for a display set: the configured count, or one
+ * per display when set to 0, never more than there are displays
+ */
+int GetToggleWorkerCount(const Config* config, const DisplaySet* set);
+
+/*
+ * Toggle every display in the set, concurrently when ctx->workers is set.
+ * With config->syncDisplays all displays are read first and then switched
+ * the same way: to the next profile only if every one is on the same
+ * profile (or at defaults), otherwise back to defaults.
+ */
+void ToggleDisplays(const ToggleContext* ctx, const DisplaySet* set, Output* out);
+
+#endif /* NVCP_TOGGLE_H */
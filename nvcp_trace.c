@@ -0,0 +1,118 @@
+/*
+ * NVCP Toggle - Trace events
+ *
+ * A writer claims a slot with one atomic add and fills it in place, so
+ * recording never locks or allocates. Each span is written as a complete
+ * ("X") event, the begin/end pair in one record.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nvcp_atomic.h"
+#include "nvcp_platform.h"
+#include "nvcp_thread.h"
+#include "nvcp_trace.h"
+
+#define TRACE_DISPLAY_SIZE 32
+
+typedef struct {
+    const char* name;  /* Static string */
+    uint64_t startNs;
+    uint64_t durationNs;
+    uint32_t thread;
+    char display[TRACE_DISPLAY_SIZE];
+} TraceEvent;
+
+static TraceEvent* ring;
+static size_t ringCapacity;
+static volatile uint64_t eventCount;
+static uint64_t traceStartNs;
+
+/*
+ * Allocate the ring and start recording
+ */
+bool EnableTrace(size_t capacity) {
+    ring = (TraceEvent*)calloc(capacity, sizeof(TraceEvent));
+    if (!ring) return false;
+    ringCapacity = capacity;
+    eventCount = 0;
+    traceStartNs = GetMonotonicNs();
+    return true;
+}
+
+/*
+ * Record a span on the calling thread
+ */
+void TraceSpan(const char* name, uint64_t startNs, uint64_t endNs, const char* display) {
+    if (!ring) return;
+
+    TraceEvent* event = &ring[AtomicAdd64(&eventCount, 1) % ringCapacity];
+    event->name = name;
+    event->startNs = startNs;
+    event->durationNs = endNs - startNs;
+    event->thread = GetCurrentThreadNumber();
+    if (display) {
+        snprintf(event->display, sizeof(event->display), "%s", display);
+    } else {
+        event->display[0] = '\0';
+    }
+}
+
+static void WriteJsonString(FILE* f, const char* str) {
+    fputc('"', f);
+    for (const char* p = str; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', f);
+            fputc(*p, f);
+        } else if ((unsigned char)*p < 0x20) {
+            fprintf(f, "\\u%04x", (unsigned char)*p);
+        } else {
+            fputc(*p, f);
+        }
+    }
+    fputc('"', f);
+}
+
+/*
+ * Write the recorded spans as Chrome trace JSON and free the ring
+ */
+bool WriteTrace(const char* path) {
+    if (!ring) return false;
+
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        free(ring);
+        ring = NULL;
+        return false;
+    }
+
+    uint64_t count = AtomicLoad64(&eventCount);
+    uint64_t first = count > ringCapacity ? count - ringCapacity : 0;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for (uint64_t i = first; i < count; i++) {
+        const TraceEvent* event = &ring[i % ringCapacity];
+        /* Chrome trace timestamps are microseconds */
+        fprintf(f, "%s{\"name\":", i == first ? "" : ",\n");
+        WriteJsonString(f, event->name);
+        fprintf(f, ",\"cat\":\"nvcp\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                event->thread, (double)(event->startNs - traceStartNs) / 1e3, (double)event->durationNs / 1e3);
+        if (event->display[0]) {
+            fprintf(f, ",\"args\":{\"display\":");
+            WriteJsonString(f, event->display);
+            fputc('}', f);
+        }
+        fputc('}', f);
+    }
+    fprintf(f, "\n]}\n");
+
+    bool ok = fclose(f) == 0;
+    if (first > 0) {
+        printf("Trace: ring full, kept the last %zu of %llu events\n", ringCapacity, (unsigned long long)count);
+    }
+    free(ring);
+    ring = NULL;
+    return ok;
+}
@@ -0,0 +1,32 @@
+/*
+ * NVCP Toggle - Trace events
+ * Spans recorded into a preallocated ring and written as a Chrome
+ * trace-event JSON file, for viewing a run in Perfetto or chrome://tracing.
+ */
+
+#ifndef NVCP_TRACE_H
+#define NVCP_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRACE_FILE_NAME "native_nvcp_trace.json"
+#define TRACE_DEFAULT_CAPACITY 16384  /* Events kept; older ones are overwritten */
+
+/*
+ * Allocate the ring and start recording. Returns false if allocation fails.
+ */
+bool EnableTrace(size_t capacity);
+
+/*
+ * Record a span on the calling thread; display may be NULL (thread-safe)
+ */
+void TraceSpan(const char* name, uint64_t startNs, uint64_t endNs, const char* display);
+
+/*
+ * Write the recorded spans, oldest first, as Chrome trace JSON and free the ring
+ */
+bool WriteTrace(const char* path);
+
+#endif /* NVCP_TRACE_H */